@@ -12,8 +12,12 @@
 
 #include "AdoCpp/Color.h"
 #include "AdoCpp/Easing.h"
+#include "AdoCpp/EmbeddedLevel.h"
 #include "AdoCpp/Event.h"
 #include "AdoCpp/Level.h"
+#include "AdoCpp/LevelBinary.h"
+#include "AdoCpp/LevelPack.h"
+#include "AdoCpp/ThreadPool.h"
 #include "AdoCpp/Utils.h"
 
 /**
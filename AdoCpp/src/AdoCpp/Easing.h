@@ -1,6 +1,10 @@
 #pragma once
-#include <stdexcept>
 #include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+#include "NameTable.h"
 
 namespace AdoCpp
 {
@@ -40,11 +44,17 @@ namespace AdoCpp
         return cstrEasing[static_cast<int>(easing)];
     }
 
-    constexpr Easing cstr2easing(const char* easing)
+    constexpr NameTable easingNames(cstrEasing);
+    constexpr std::optional<Easing> tryCstr2easing(const std::string_view easing) noexcept
+    {
+        if (const auto index = easingNames.find(easing))
+            return static_cast<Easing>(*index);
+        return std::nullopt;
+    }
+    constexpr Easing cstr2easing(const char* const easing)
     {
-        for (int i = 0; i < std::size(cstrEasing); ++i)
-            if (strcmp(easing, cstrEasing[i]) == 0)
-                return static_cast<Easing>(i);
+        if (const auto value = tryCstr2easing(easing))
+            return *value;
         throw std::invalid_argument(easing);
     }
 
@@ -0,0 +1,41 @@
+#include "EmbeddedLevel.h"
+
+#include <vector>
+
+#include "Level.h"
+
+namespace AdoCpp
+{
+    namespace
+    {
+        // A function-local static, so registering from other translation units does not depend on their order.
+        std::vector<const EmbeddedLevel*>& registry()
+        {
+            static std::vector<const EmbeddedLevel*> levels;
+            return levels;
+        }
+    } // namespace
+
+    EmbeddedLevelRegistrar::EmbeddedLevelRegistrar(const EmbeddedLevel& level) { registry().push_back(&level); }
+
+    std::span<const EmbeddedLevel* const> embeddedLevels() noexcept { return registry(); }
+    const EmbeddedLevel* findEmbeddedLevel(const std::string_view name) noexcept
+    {
+        for (const auto* level : registry())
+            if (level->name == name)
+                return level;
+        return nullptr;
+    }
+
+    void Level::fromEmbedded(const EmbeddedLevel& level)
+    {
+        fromBinary(reinterpret_cast<const char*>(level.data), level.size);
+    }
+    void Level::fromEmbedded(const std::string_view name)
+    {
+        const auto* level = findEmbeddedLevel(name);
+        if (!level)
+            throw LevelNotEmbeddedException();
+        fromEmbedded(*level);
+    }
+} // namespace AdoCpp
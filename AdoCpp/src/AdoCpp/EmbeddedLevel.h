@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace AdoCpp
+{
+    /**
+     * Embedded levels are generated at build time by AdoCppEmbed (see adocpp_embed_level() in EmbedLevel.cmake):
+     * each one is defined as AdoCpp::Embedded::<name> in a generated source file, declared in a generated header
+     * <name>.h, and registered under its name before main() runs.
+     * @brief A compiled level linked into the executable.
+     */
+    struct EmbeddedLevel
+    {
+        const char* name;
+        /**
+         * @brief The bytes of the compiled level (see LevelBinary.h).
+         */
+        const unsigned char* data;
+        size_t size;
+    };
+
+    /**
+     * @brief Registers an embedded level when it is constructed (used by the generated source files).
+     */
+    class EmbeddedLevelRegistrar
+    {
+    public:
+        explicit EmbeddedLevelRegistrar(const EmbeddedLevel& level);
+    };
+
+    /**
+     * @brief Get the levels embedded into the executable, in registration order.
+     */
+    [[nodiscard]] std::span<const EmbeddedLevel* const> embeddedLevels() noexcept;
+    /**
+     * @brief Find a level embedded into the executable.
+     * @param name The name of the level.
+     * @return The level, or nullptr if there is none with this name.
+     */
+    [[nodiscard]] const EmbeddedLevel* findEmbeddedLevel(std::string_view name) noexcept;
+} // namespace AdoCpp
@@ -1,43 +1,101 @@
 #include "Event.h"
-#include <sstream>
+#include <memory>
+#include <stdexcept>
+#include "JsonReader.h"
 #include "Level.h"
+#include "NameTable.h"
 
 namespace AdoCpp
 {
-    Event::Event* Event::newEvent(const rapidjson::Value& json)
+    namespace
     {
-        const char* eventType = json["eventType"].GetString();
-        if (strcmp(eventType, "SetSpeed") == 0)
-            return new GamePlay::SetSpeed(json);
-        if (strcmp(eventType, "Twirl") == 0)
-            return new GamePlay::Twirl(json);
-        if (strcmp(eventType, "Pause") == 0)
-            return new GamePlay::Pause(json);
-        if (strcmp(eventType, "SetHitsound") == 0)
-            return new GamePlay::SetHitsound(json);
-        if (strcmp(eventType, "SetPlanetRotation") == 0)
-            return new GamePlay::SetPlanetRotation(json);
-
-        if (strcmp(eventType, "ColorTrack") == 0)
-            return new Track::ColorTrack(json);
-        if (strcmp(eventType, "AnimateTrack") == 0)
-            return new Track::AnimateTrack(json);
-        if (strcmp(eventType, "RecolorTrack") == 0)
-            return new Track::RecolorTrack(json);
-        if (strcmp(eventType, "PositionTrack") == 0)
-            return new Track::PositionTrack(json);
-        if (strcmp(eventType, "MoveTrack") == 0)
-            return new Track::MoveTrack(json);
-
-        if (strcmp(eventType, "MoveCamera") == 0)
-            return new Visual::MoveCamera(json);
+        template <typename T>
+        Event::Event* construct()
+        {
+            return new T;
+        }
 
-        if (strcmp(eventType, "RepeatEvents") == 0)
-            return new Modifiers::RepeatEvents(json);
-
-        if (strcmp(eventType, "Hold") == 0)
-            return new Dlc::Hold(json);
+        // clang-format off
+        constexpr const char* const cstrEventType[] = {
+            "SetSpeed", "Twirl", "Pause", "SetHitsound", "SetPlanetRotation",
+            "ColorTrack", "AnimateTrack", "RecolorTrack", "PositionTrack", "MoveTrack",
+            "MoveCamera",
+            "RepeatEvents",
+            "Hold",
+        };
+        constexpr Event::Event* (*const eventFactories[])() = {
+            construct<Event::GamePlay::SetSpeed>, construct<Event::GamePlay::Twirl>,
+            construct<Event::GamePlay::Pause>, construct<Event::GamePlay::SetHitsound>,
+            construct<Event::GamePlay::SetPlanetRotation>,
+            construct<Event::Track::ColorTrack>, construct<Event::Track::AnimateTrack>,
+            construct<Event::Track::RecolorTrack>, construct<Event::Track::PositionTrack>,
+            construct<Event::Track::MoveTrack>,
+            construct<Event::Visual::MoveCamera>,
+            construct<Event::Modifiers::RepeatEvents>,
+            construct<Event::Dlc::Hold>,
+        };
+        // Whether Level::parse(..., basic = true) can do without the event.
+        constexpr bool deferrable[] = {
+            false, false, false, false, true,
+            false, false, true, false, true,
+            true,
+            true,
+            false,
+        };
+        // clang-format on
+        static_assert(std::size(cstrEventType) == std::size(eventFactories));
+        static_assert(std::size(cstrEventType) == std::size(deferrable));
+        constexpr NameTable eventTypeNames(cstrEventType);
+    } // namespace
 
+    Event::Event* Event::newEvent(const rapidjson::Value& json)
+    {
+        if (json.IsObject())
+        {
+            if (const auto eventType = json.FindMember("eventType");
+                eventType != json.MemberEnd() && eventType->value.IsString() &&
+                !eventTypeNames.find({eventType->value.GetString(), eventType->value.GetStringLength()}))
+                return nullptr;
+        }
+        std::string error;
+        if (const auto event = tryNewEvent(json, error))
+            return event;
+        throw std::invalid_argument(error);
+    }
+    Event::Event* Event::tryNewEvent(const rapidjson::Value& json, std::string& error)
+    {
+        if (!json.IsObject())
+        {
+            error = "the action is not an object";
+            return nullptr;
+        }
+        const auto eventType = json.FindMember("eventType");
+        if (eventType == json.MemberEnd() || !eventType->value.IsString())
+        {
+            error = "the action has no eventType";
+            return nullptr;
+        }
+        const std::string_view name(eventType->value.GetString(), eventType->value.GetStringLength());
+        std::unique_ptr<Event> event;
+        if (const auto index = eventTypeNames.find(name))
+            event.reset(eventFactories[*index]());
+        else
+            event = std::make_unique<Unknown>();
+        JsonReader reader(json);
+        event->read(reader);
+        if (!reader.ok())
+        {
+            error = name;
+            error += ": ";
+            error += reader.error();
+            return nullptr;
+        }
+        return event.release();
+    }
+    const char* Event::deferrableEventType(const std::string_view eventType) noexcept
+    {
+        if (const auto index = eventTypeNames.find(eventType); index && deferrable[*index])
+            return cstrEventType[*index];
         return nullptr;
     }
 } // namespace AdoCpp
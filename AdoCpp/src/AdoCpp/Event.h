@@ -3,10 +3,12 @@
 
 // ReSharper disable CppUnusedIncludeDirective
 #include "Easing.h"
+#include "Events/Deferred.h"
 #include "Events/Dlc.h"
 #include "Events/GamePlay.h"
 #include "Events/Modifiers.h"
 #include "Events/Track.h"
+#include "Events/Unknown.h"
 #include "Events/Visual.h"
 #include "Utils.h"
 // ReSharper restore CppUnusedIncludeDirective
@@ -16,5 +18,26 @@
  */
 namespace AdoCpp::Event
 {
+    /**
+     * @brief Create an event from json data.
+     * @param json The json data of the action.
+     * @return The event, or nullptr if its eventType is not supported.
+     * @throw std::invalid_argument If the action is invalid.
+     */
     Event* newEvent(const rapidjson::Value& json);
+    /**
+     * Nothing is thrown. The actions that are not supported are kept as Unknown events.
+     * @brief Create an event from json data.
+     * @param json The json data of the action.
+     * @param error Set to what is wrong with the action if it is invalid.
+     * @return The event, or nullptr if the action is invalid.
+     */
+    Event* tryNewEvent(const rapidjson::Value& json, std::string& error);
+    /**
+     * These are the eventTypes that only the full parse looks at (see Level::lazyDecoding()).
+     * @brief Get whether the decoding of an eventType can be deferred.
+     * @param eventType The eventType.
+     * @return The eventType as a static string, or nullptr if its decoding cannot be deferred.
+     */
+    const char* deferrableEventType(std::string_view eventType) noexcept;
 }
@@ -1,11 +1,22 @@
 #include "Base.h"
+#include <stdexcept>
+#include "AdoCpp/JsonReader.h"
+#include "Fields.h"
 
 namespace AdoCpp::Event
 {
-    Event::Event(const rapidjson::Value& data)
+    namespace
     {
-        floor = data["floor"].GetUint64();
-        active = !data.HasMember("active") || toBool(data["active"]);
+        constexpr FieldTable eventFieldTable(eventFields);
+        constexpr FieldTable dynamicEventFieldTable(dynamicEventFields);
+    } // namespace
+
+    Event::Event(const rapidjson::Value& data) { readOrThrow(data); }
+    std::unique_ptr<rapidjson::Value> Event::intoJson(rapidjson::Document::AllocatorType& alloc) const
+    {
+        JsonValueWriter writer(alloc);
+        write(writer);
+        return std::make_unique<rapidjson::Value>(writer.take());
     }
     std::unique_ptr<rapidjson::Document> Event::intoJson() const
     {
@@ -13,12 +24,22 @@ namespace AdoCpp::Event
         doc->CopyFrom(*intoJson(doc->GetAllocator()), doc->GetAllocator());
         return doc;
     }
-    StaticEvent::StaticEvent(const rapidjson::Value& data) : Event(data) {}
-    DynamicEvent::DynamicEvent(const rapidjson::Value& data) : Event(data)
+    void Event::read(JsonReader& reader) { eventFieldTable.read(reader, *this); }
+    void Event::readOrThrow(const rapidjson::Value& data)
+    {
+        JsonReader reader(data);
+        read(reader);
+        if (!reader.ok())
+            throw std::invalid_argument(reader.error());
+    }
+    void Event::writeHeader(JsonWriter& writer) const
     {
-        if (data.HasMember("angleOffset"))
-            angleOffset = data["angleOffset"].GetDouble();
-        if (data.HasMember("eventTag"))
-            eventTag = cstr2tags(data["eventTag"].GetString());
+        writer.member("floor", floor);
+        writer.member("eventType", name());
+        if (!active)
+            writer.member("active", active);
     }
+    StaticEvent::StaticEvent(const rapidjson::Value& data) { readOrThrow(data); }
+    DynamicEvent::DynamicEvent(const rapidjson::Value& data) { readOrThrow(data); }
+    void DynamicEvent::read(JsonReader& reader) { dynamicEventFieldTable.read(reader, *this); }
 } // namespace AdoCpp::Event
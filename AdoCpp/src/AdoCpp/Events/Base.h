@@ -3,8 +3,14 @@
 #include <rapidjson/document.h>
 #include <string>
 #include <vector>
+#include "AdoCpp/JsonWriter.h"
 #include "AdoCpp/Utils.h"
 
+namespace AdoCpp
+{
+    class JsonReader;
+}
+
 namespace AdoCpp::Event
 {
     /**
@@ -30,9 +36,42 @@ namespace AdoCpp::Event
          * @return The cloned event.
          */
         [[nodiscard]] constexpr virtual Event* clone() const = 0;
-        [[nodiscard]] virtual std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const = 0;
+        /**
+         * @brief Write the event as the json object of an action.
+         * @param writer The writer.
+         */
+        virtual void write(JsonWriter& writer) const = 0;
+        [[nodiscard]] std::unique_ptr<rapidjson::Value> intoJson(rapidjson::Document::AllocatorType& alloc) const;
         [[nodiscard]] std::unique_ptr<rapidjson::Document> intoJson() const;
+        /**
+         * Problems are reported to the reader instead of being thrown,
+         * and the fields they concern keep their values.
+         * @brief Read the members of an action into the event.
+         * @param reader The reader of the json object of the action.
+         */
+        virtual void read(JsonReader& reader);
+
+    protected:
+        /**
+         * @brief Read the json object of an action into the event (see read()).
+         * @throw std::invalid_argument If there is a problem with the action.
+         */
+        void readOrThrow(const rapidjson::Value& data);
+        /**
+         * @brief Write the members every action starts with (floor, eventType and active if it is not).
+         */
+        void writeHeader(JsonWriter& writer) const;
+        /**
+         * @brief Write an event as an action: the header, then the fields of its FieldTable.
+         */
+        template <typename Self, typename Table>
+        static void writeAction(JsonWriter& writer, const Self& self, const Table& table)
+        {
+            writer.startObject();
+            static_cast<const Event&>(self).writeHeader(writer);
+            table.write(writer, self);
+            writer.endObject();
+        }
     };
 
     /**
@@ -56,6 +95,7 @@ namespace AdoCpp::Event
         ~DynamicEvent() override = default;
         explicit DynamicEvent(const rapidjson::Value& data);
         [[nodiscard]] constexpr DynamicEvent* clone() const override = 0;
+        void read(JsonReader& reader) override;
         double angleOffset = 0;
         double beat = 0;
         double seconds = 0;
@@ -0,0 +1,35 @@
+#include "Deferred.h"
+
+#include <string_view>
+#include "AdoCpp/Event.h"
+
+namespace AdoCpp::Event
+{
+    Deferred::Deferred(const char* const eventType, std::shared_ptr<const rapidjson::Value> actions,
+                       const rapidjson::SizeType index, const size_t action) :
+        m_eventType(eventType), m_actions(std::move(actions)), m_index(index), m_action(action)
+    {
+    }
+    void Deferred::write(JsonWriter& writer) const
+    {
+        writer.startObject();
+        writeHeader(writer);
+        for (const auto& member : json().GetObject())
+        {
+            if (const std::string_view key(member.name.GetString(), member.name.GetStringLength());
+                key != "floor" && key != "eventType" && key != "active")
+            {
+                writer.key(key);
+                writer.json(member.value);
+            }
+        }
+        writer.endObject();
+    }
+    Event* Deferred::decode(std::string& error) const
+    {
+        Event* const event = tryNewEvent(json(), error);
+        if (event)
+            event->floor = floor, event->active = active;
+        return event;
+    }
+} // namespace AdoCpp::Event
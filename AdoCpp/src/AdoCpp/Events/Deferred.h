@@ -0,0 +1,51 @@
+#pragma once
+#include <memory>
+#include "Base.h"
+
+namespace AdoCpp::Event
+{
+    /**
+     * Only floor and active are decoded. The action stays a rapidjson value until decode() builds the real event;
+     * until then it is written back with its members as they were read.
+     * @brief An action whose decoding has been deferred (see Level::lazyDecoding()).
+     */
+    class Deferred final : public Event
+    {
+    public:
+        /**
+         * Floor and active are left to read().
+         * @brief Constructor.
+         * @param eventType The eventType (see deferrableEventType()).
+         * @param actions The array that holds the action, shared by the actions deferred together.
+         * @param index The index of the action in the array.
+         * @param action The index of the action in the actions array of the level, for diagnostics.
+         */
+        Deferred(const char* eventType, std::shared_ptr<const rapidjson::Value> actions, rapidjson::SizeType index,
+                 size_t action);
+        [[nodiscard]] constexpr bool stackable() const noexcept override { return true; }
+        [[nodiscard]] const char* name() const noexcept override { return m_eventType; }
+        [[nodiscard]] Deferred* clone() const override { return new Deferred(*this); }
+        void write(JsonWriter& writer) const override;
+        /**
+         * @brief Get the json object of the action.
+         */
+        [[nodiscard]] const rapidjson::Value& json() const noexcept { return (*m_actions)[m_index]; }
+        /**
+         * @brief Get the index of the action in the actions array of the level.
+         */
+        [[nodiscard]] size_t action() const noexcept { return m_action; }
+        /**
+         * Floor and active are taken from this event, not from the json.
+         * @brief Build the event.
+         * @param error Set to what is wrong with the action if it is invalid.
+         * @return The event, or nullptr if the action is invalid.
+         */
+        [[nodiscard]] Event* decode(std::string& error) const;
+
+    private:
+        const char* m_eventType;
+        std::shared_ptr<const rapidjson::Value> m_actions;
+        rapidjson::SizeType m_index;
+        size_t m_action;
+    };
+} // namespace AdoCpp::Event
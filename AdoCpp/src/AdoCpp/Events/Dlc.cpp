@@ -1,21 +1,22 @@
 #include "Dlc.h"
+#include "AdoCpp/FieldTable.h"
+#include "AdoCpp/JsonReader.h"
+#include "Fields.h"
 
 namespace AdoCpp::Event::Dlc
 {
-    Hold::Hold(const rapidjson::Value& data) : StaticEvent(data)
+    namespace
     {
-        duration = data["duration"].GetDouble();
-        distanceMultiplier = data["distanceMultiplier"].GetDouble();
-        landingAnimation = data["landingAnimation"].GetBool();
-    }
-    std::unique_ptr<rapidjson::Value> Hold::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-        autoRemoveDecimalPart(*val, "duration", duration, alloc);
-        autoRemoveDecimalPart(*val, "distanceMultiplier", distanceMultiplier, alloc);
-        val->AddMember("landingAnimation", landingAnimation, alloc);
-        return val;
-    }
+        // clang-format off
+        constexpr FieldTable holdFields(std::tuple_cat(eventFields, std::tuple{
+            field("duration",           &Hold::duration),
+            field("distanceMultiplier", &Hold::distanceMultiplier),
+            field("landingAnimation",   &Hold::landingAnimation),
+        }));
+        // clang-format on
+    } // namespace
+
+    Hold::Hold(const rapidjson::Value& data) { readOrThrow(data); }
+    void Hold::read(JsonReader& reader) { holdFields.read(reader, *this); }
+    void Hold::write(JsonWriter& writer) const { writeAction(writer, *this, holdFields); }
 } // namespace AdoCpp::Event::Dlc
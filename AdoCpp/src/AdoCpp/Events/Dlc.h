@@ -11,8 +11,8 @@ namespace AdoCpp::Event::Dlc
         [[nodiscard]] constexpr bool stackable() const noexcept override { return false; }
         [[nodiscard]] constexpr const char* name() const noexcept override { return "Hold"; }
         [[nodiscard]] constexpr Hold* clone() const override { return new Hold(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
         double duration = 1;
         double distanceMultiplier = 1;
         bool landingAnimation = false;
@@ -0,0 +1,23 @@
+#pragma once
+#include <tuple>
+#include "AdoCpp/FieldTable.h"
+#include "Base.h"
+
+namespace AdoCpp::Event
+{
+    /**
+     * floor and active are written by Event::writeHeader().
+     * @brief The fields every action has, for the FieldTables of the events.
+     */
+    inline constexpr auto eventFields = std::tuple{
+        field("floor", &Event::floor, Required | ReadOnly),
+        field("active", &Event::active, Optional | ReadOnly),
+    };
+    /**
+     * @brief The fields every dynamic action has.
+     */
+    inline constexpr auto dynamicEventFields = std::tuple_cat(eventFields, std::tuple{
+        field("angleOffset", &DynamicEvent::angleOffset, Optional),
+        field("eventTag", &DynamicEvent::eventTag, Optional),
+    });
+} // namespace AdoCpp::Event
@@ -1,135 +1,145 @@
 #include "GamePlay.h"
-#include <cstring>
+#include <optional>
+#include <string_view>
+#include "AdoCpp/FieldTable.h"
+#include "AdoCpp/JsonReader.h"
+#include "Fields.h"
 #include "rapidjson/document.h"
 
 namespace AdoCpp::Event::GamePlay
 {
-    SetSpeed::SetSpeed(const rapidjson::Value& data) : DynamicEvent(data)
+    namespace
     {
-        beatsPerMinute = data["beatsPerMinute"].GetDouble();
-        if (!data.HasMember("speedType"))
+        std::optional<SetSpeed::SpeedType> tryCstr2speedType(const std::string_view str) noexcept
         {
-            speedType = SpeedType::Bpm;
-            return;
+            if (str == "Bpm")
+                return SetSpeed::SpeedType::Bpm;
+            if (str == "Multiplier")
+                return SetSpeed::SpeedType::Multiplier;
+            return std::nullopt;
         }
-        if (strcmp(data["speedType"].GetString(), "Bpm") == 0)
-            speedType = SpeedType::Bpm;
-        else if (strcmp(data["speedType"].GetString(), "Multiplier") == 0)
-            speedType = SpeedType::Multiplier;
-        else
-            throw std::invalid_argument("Invalid speedType");
-        bpmMultiplier = data["bpmMultiplier"].GetDouble();
-    }
-    std::unique_ptr<rapidjson::Value> SetSpeed::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-
-        if (speedType == SpeedType::Bpm)
-            val->AddMember("speedType", "Bpm", alloc);
-        else
-            val->AddMember("speedType", "Multiplier", alloc);
-        autoRemoveDecimalPart(*val, "beatsPerMinute", beatsPerMinute, alloc);
-        autoRemoveDecimalPart(*val, "bpmMultiplier", bpmMultiplier, alloc);
-        autoRemoveDecimalPart(*val, "angleOffset", angleOffset, alloc);
-        return val;
-    }
-    Twirl::Twirl(const rapidjson::Value& data) : StaticEvent(data) {}
-
-    std::unique_ptr<rapidjson::Value> Twirl::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-        return val;
-    }
-    Pause::Pause(const rapidjson::Value& data) : StaticEvent(data)
-    {
-        duration = data["duration"].GetDouble();
-        countdownTicks = data["countdownTicks"].GetDouble();
-        if (data["angleCorrectionDir"].IsString())
+        const char* speedType2cstr(const SetSpeed::SpeedType& speedType)
         {
-            if (const char* const str = data["angleCorrectionDir"].GetString(); strcmp(str, "Backward") == 0)
-                angleCorrectionDir = AngleCorrectionDir::Backward;
-            else if (strcmp(str, "None") == 0)
-                angleCorrectionDir = AngleCorrectionDir::None;
-            else if (strcmp(str, "Forward") == 0)
-                angleCorrectionDir = AngleCorrectionDir::Forward;
-            else
-                throw std::invalid_argument("Invalid angleCorrectionDir");
+            return speedType == SetSpeed::SpeedType::Bpm ? "Bpm" : "Multiplier";
         }
-        else
+        std::optional<Pause::AngleCorrectionDir> tryCstr2angleCorrectionDir(const std::string_view str) noexcept
         {
-            if (const int dir = data["angleCorrectionDir"].GetInt(); -1 <= dir && dir <= 1)
-                angleCorrectionDir = static_cast<AngleCorrectionDir>(data["angleCorrectionDir"].GetInt());
-            else
-                throw std::invalid_argument("Invalid angleCorrectionDir");
+            if (str == "Backward")
+                return Pause::AngleCorrectionDir::Backward;
+            if (str == "None")
+                return Pause::AngleCorrectionDir::None;
+            if (str == "Forward")
+                return Pause::AngleCorrectionDir::Forward;
+            return std::nullopt;
         }
-    }
-    std::unique_ptr<rapidjson::Value> Pause::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-        autoRemoveDecimalPart(*val, "duration", duration, alloc);
-        autoRemoveDecimalPart(*val, "countdownTicks", countdownTicks, alloc);
-        if (angleCorrectionDir == AngleCorrectionDir::None)
-            val->AddMember("angleCorrectionDir", "None", alloc);
-        else if (angleCorrectionDir == AngleCorrectionDir::Forward)
-            val->AddMember("angleCorrectionDir", "Forward", alloc);
-        else
-            val->AddMember("angleCorrectionDir", "Backward", alloc);
-        return val;
-    }
-    SetHitsound::SetHitsound(const rapidjson::Value& data)
-    {
-        if (!data.HasMember("gameSound") || !strcmp(data["gameSound"].GetString(), "Hitsound"))
-            gameSound = GameSound::Hitsound;
-        else if (!strcmp(data["gameSound"].GetString(), "Midspin"))
-            gameSound = GameSound::Midspin;
-        else
-            throw std::invalid_argument("Invalid gameSound");
-        hitsound = cstr2hitsound(data["hitsound"].GetString());
-        hitsoundVolume = data["hitsoundVolume"].GetDouble();
-    }
-    std::unique_ptr<rapidjson::Value> SetHitsound::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
+        const char* angleCorrectionDir2cstr(const Pause::AngleCorrectionDir& dir)
+        {
+            switch (dir)
+            {
+            case Pause::AngleCorrectionDir::None:
+                return "None";
+            case Pause::AngleCorrectionDir::Forward:
+                return "Forward";
+            default:
+                return "Backward";
+            }
+        }
+        std::optional<SetHitsound::GameSound> tryCstr2gameSound(const std::string_view str) noexcept
+        {
+            if (str == "Hitsound")
+                return SetHitsound::GameSound::Hitsound;
+            if (str == "Midspin")
+                return SetHitsound::GameSound::Midspin;
+            return std::nullopt;
+        }
+        const char* gameSound2cstr(const SetHitsound::GameSound& gameSound)
+        {
+            return gameSound == SetHitsound::GameSound::Midspin ? "Midspin" : "Hitsound";
+        }
+        std::optional<SetPlanetRotation::EasePartBehavior> tryCstr2easePartBehavior(const std::string_view str) noexcept
+        {
+            // Anything but Repeat has always been read as Mirror.
+            return str == "Repeat" ? SetPlanetRotation::EasePartBehavior::Repeat
+                                   : SetPlanetRotation::EasePartBehavior::Mirror;
+        }
+        const char* easePartBehavior2cstr(const SetPlanetRotation::EasePartBehavior& easePartBehavior)
+        {
+            return easePartBehavior == SetPlanetRotation::EasePartBehavior::Mirror ? "Mirror" : "Repeat";
+        }
+        /**
+         * @brief The direction of a Pause, which older levels store as -1, 0 or 1.
+         */
+        struct AngleCorrectionDirCodec : EnumCodec<Pause::AngleCorrectionDir>
+        {
+            bool read(JsonReader& reader, const std::string_view key, const rapidjson::Value& value,
+                      Pause::AngleCorrectionDir& out) const
+            {
+                if (!value.IsInt())
+                    return EnumCodec::read(reader, key, value, out);
+                if (value.GetInt() < -1 || value.GetInt() > 1)
+                {
+                    reader.fail(key, "has an invalid value");
+                    return false;
+                }
+                out = static_cast<Pause::AngleCorrectionDir>(value.GetInt());
+                return true;
+            }
+        };
 
-        if (gameSound == GameSound::Hitsound)
-            val->AddMember("gameSound", "Hitsound", alloc);
-        else if (gameSound == GameSound::Midspin)
-            val->AddMember("gameSound", "Midspin", alloc);
-        val->AddMember("hitsound", rapidjson::StringRef(hitsound2cstr(hitsound)), alloc);
-        autoRemoveDecimalPart(*val, "hitsoundVolume", hitsoundVolume, alloc);
-        return val;
-    }
+        // clang-format off
+        constexpr FieldTable setSpeedFields(std::tuple_cat(dynamicEventFields, std::tuple{
+            defaultedField("speedType", &SetSpeed::speedType, SetSpeed::SpeedType::Bpm,
+                           EnumCodec{tryCstr2speedType, speedType2cstr}),
+            field("beatsPerMinute",     &SetSpeed::beatsPerMinute),
+            field("bpmMultiplier",      &SetSpeed::bpmMultiplier, Optional),
+        }));
+        constexpr FieldTable pauseFields(std::tuple_cat(eventFields, std::tuple{
+            field("duration",           &Pause::duration),
+            field("countdownTicks",     &Pause::countdownTicks),
+            field("angleCorrectionDir", &Pause::angleCorrectionDir, Required,
+                  AngleCorrectionDirCodec{{tryCstr2angleCorrectionDir, angleCorrectionDir2cstr}}),
+        }));
+        constexpr FieldTable setHitsoundFields(std::tuple_cat(eventFields, std::tuple{
+            defaultedField("gameSound", &SetHitsound::gameSound, SetHitsound::GameSound::Hitsound,
+                           EnumCodec{tryCstr2gameSound, gameSound2cstr}),
+            field("hitsound",           &SetHitsound::hitsound, Required, EnumCodec{tryCstr2hitsound, hitsound2cstr}),
+            field("hitsoundVolume",     &SetHitsound::hitsoundVolume),
+        }));
+        constexpr FieldTable setPlanetRotationFields(std::tuple_cat(eventFields, std::tuple{
+            field("ease",                      &SetPlanetRotation::ease, Required, EnumCodec{tryCstr2easing, easing2cstr}),
+            field("easeParts",                 &SetPlanetRotation::easeParts),
+            defaultedField("easePartBehavior", &SetPlanetRotation::easePartBehavior,
+                           SetPlanetRotation::EasePartBehavior::Repeat,
+                           EnumCodec{tryCstr2easePartBehavior, easePartBehavior2cstr}),
+        }));
+        // clang-format on
+    } // namespace
 
-    SetPlanetRotation::SetPlanetRotation(const rapidjson::Value& data) : StaticEvent(data)
+    SetSpeed::SetSpeed(const rapidjson::Value& data) { readOrThrow(data); }
+    void SetSpeed::read(JsonReader& reader)
     {
-        ease = cstr2easing(data["ease"].GetString());
-        easeParts = data["easeParts"].GetUint64();
-        easePartBehavior =
-            !data.HasMember("easePartBehavior") || !strcmp(data["easePartBehavior"].GetString(), "Repeat")
-            ? EasePartBehavior::Repeat
-            : EasePartBehavior::Mirror;
+        setSpeedFields.read(reader, *this);
+        // The multiplier is only needed by the levels that have a speedType.
+        if (reader.has("speedType") && !reader.has("bpmMultiplier"))
+            reader.fail("bpmMultiplier", "is missing");
     }
-    std::unique_ptr<rapidjson::Value> SetPlanetRotation::intoJson(rapidjson::Document::AllocatorType& alloc) const
+    void SetSpeed::write(JsonWriter& writer) const { writeAction(writer, *this, setSpeedFields); }
+    Twirl::Twirl(const rapidjson::Value& data) { readOrThrow(data); }
+
+    void Twirl::write(JsonWriter& writer) const
     {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-        if (!active)
-            val->AddMember("active", active, alloc);
-        val->AddMember("ease", rapidjson::StringRef(easing2cstr(ease)), alloc);
-        val->AddMember("easeParts", easeParts, alloc);
-        if (easePartBehavior == EasePartBehavior::Repeat)
-            val->AddMember("easePartBehavior", "Repeat", alloc);
-        else if (easePartBehavior == EasePartBehavior::Mirror)
-            val->AddMember("easePartBehavior", "Mirror", alloc);
-        return val;
+        writer.startObject();
+        writeHeader(writer);
+        writer.endObject();
     }
+    Pause::Pause(const rapidjson::Value& data) { readOrThrow(data); }
+    void Pause::read(JsonReader& reader) { pauseFields.read(reader, *this); }
+    void Pause::write(JsonWriter& writer) const { writeAction(writer, *this, pauseFields); }
+    SetHitsound::SetHitsound(const rapidjson::Value& data) { readOrThrow(data); }
+    void SetHitsound::read(JsonReader& reader) { setHitsoundFields.read(reader, *this); }
+    void SetHitsound::write(JsonWriter& writer) const { writeAction(writer, *this, setHitsoundFields); }
+
+    SetPlanetRotation::SetPlanetRotation(const rapidjson::Value& data) { readOrThrow(data); }
+    void SetPlanetRotation::read(JsonReader& reader) { setPlanetRotationFields.read(reader, *this); }
+    void SetPlanetRotation::write(JsonWriter& writer) const { writeAction(writer, *this, setPlanetRotationFields); }
 } // namespace AdoCpp::Event::GamePlay
@@ -19,8 +19,8 @@ namespace AdoCpp::Event::GamePlay
         [[nodiscard]] constexpr bool stackable() const noexcept override { return true; }
         [[nodiscard]] constexpr const char* name() const noexcept override { return "SetSpeed"; }
         [[nodiscard]] constexpr SetSpeed* clone() const override { return new SetSpeed(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
         SpeedType speedType = SpeedType::Bpm;
         double beatsPerMinute = 100;
         double bpmMultiplier = 1;
@@ -33,8 +33,7 @@ namespace AdoCpp::Event::GamePlay
         [[nodiscard]] constexpr bool stackable() const noexcept override { return false; }
         [[nodiscard]] constexpr const char* name() const noexcept override { return "Twirl"; }
         [[nodiscard]] constexpr Twirl* clone() const override { return new Twirl(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
     };
     class Pause final : public StaticEvent
     {
@@ -44,8 +43,8 @@ namespace AdoCpp::Event::GamePlay
         [[nodiscard]] constexpr bool stackable() const noexcept override { return false; };
         [[nodiscard]] constexpr const char* name() const noexcept override { return "Pause"; };
         [[nodiscard]] constexpr Pause* clone() const override { return new Pause(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
         double duration = 0;
         double countdownTicks = 0;
         enum class AngleCorrectionDir
@@ -69,8 +68,8 @@ namespace AdoCpp::Event::GamePlay
         [[nodiscard]] constexpr bool stackable() const noexcept override { return false; }
         [[nodiscard]] constexpr const char* name() const noexcept override { return "SetHitsound"; }
         [[nodiscard]] constexpr SetHitsound* clone() const override { return new SetHitsound(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
         GameSound gameSound = GameSound::Hitsound;
         Hitsound hitsound = Hitsound::Kick;
         double hitsoundVolume = 100;
@@ -88,8 +87,8 @@ namespace AdoCpp::Event::GamePlay
         [[nodiscard]] constexpr bool stackable() const noexcept override { return false; };
         [[nodiscard]] constexpr const char* name() const noexcept override { return "SetPlanetRotation"; };
         [[nodiscard]] constexpr SetPlanetRotation* clone() const override { return new SetPlanetRotation(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
         Easing ease = Easing::Linear;
         uint64_t easeParts = 1;
         EasePartBehavior easePartBehavior = EasePartBehavior::Repeat;
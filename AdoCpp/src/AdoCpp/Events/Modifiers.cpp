@@ -1,35 +1,38 @@
 #include "Modifiers.h"
+#include <optional>
+#include <string_view>
+#include "AdoCpp/FieldTable.h"
+#include "AdoCpp/JsonReader.h"
+#include "Fields.h"
 
 namespace AdoCpp::Event::Modifiers
 {
-    RepeatEvents::RepeatEvents(const rapidjson::Value& data) : Event(data)
+    namespace
     {
-        if (data.HasMember("repeatType") && !strcmp(data["repeatType"].GetString(), "Floor"))
-            repeatType = RepeatType::Floor;
-        else
-            repeatType = RepeatType::Beat;
-        repetitions = data["repetitions"].GetUint64();
-        floorCount = data.HasMember("floorCount") ? data["floorCount"].GetUint64() : 0;
-        interval = data["interval"].GetDouble();
-        executeOnCurrentFloor = data.HasMember("executeOnCurrentFloor") ? toBool(data["executeOnCurrentFloor"]) : false;
-        tag = cstr2tags(data["tag"].GetString());
-    }
-    std::unique_ptr<rapidjson::Value> RepeatEvents::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-        if (!active)
-            val->AddMember("active", active, alloc);
-        if (repeatType == RepeatType::Floor)
-            val->AddMember("repeatType", "Floor", alloc);
-        else if (repeatType == RepeatType::Beat)
-            val->AddMember("repeatType", "Beat", alloc);
-        val->AddMember("repetitions", repetitions, alloc);
-        val->AddMember("floorCount", floorCount, alloc);
-        autoRemoveDecimalPart(*val, "interval", interval, alloc);
-        val->AddMember("executeOnCurrentFloor", executeOnCurrentFloor, alloc);
-        addTag(*val, tag, alloc, true);
-        return val;
-    }
+        std::optional<RepeatEvents::RepeatType> tryCstr2repeatType(const std::string_view str) noexcept
+        {
+            // Anything but Floor has always been read as Beat.
+            return str == "Floor" ? RepeatEvents::RepeatType::Floor : RepeatEvents::RepeatType::Beat;
+        }
+        const char* repeatType2cstr(const RepeatEvents::RepeatType& repeatType)
+        {
+            return repeatType == RepeatEvents::RepeatType::Floor ? "Floor" : "Beat";
+        }
+
+        // clang-format off
+        constexpr FieldTable repeatEventsFields(std::tuple_cat(eventFields, std::tuple{
+            defaultedField("repeatType",            &RepeatEvents::repeatType, RepeatEvents::RepeatType::Beat,
+                           EnumCodec{tryCstr2repeatType, repeatType2cstr}),
+            field("repetitions",                    &RepeatEvents::repetitions),
+            defaultedField("floorCount",            &RepeatEvents::floorCount, size_t{0}),
+            field("interval",                       &RepeatEvents::interval),
+            defaultedField("executeOnCurrentFloor", &RepeatEvents::executeOnCurrentFloor, false),
+            field("tag",                            &RepeatEvents::tag),
+        }));
+        // clang-format on
+    } // namespace
+
+    RepeatEvents::RepeatEvents(const rapidjson::Value& data) { readOrThrow(data); }
+    void RepeatEvents::read(JsonReader& reader) { repeatEventsFields.read(reader, *this); }
+    void RepeatEvents::write(JsonWriter& writer) const { writeAction(writer, *this, repeatEventsFields); }
 } // namespace AdoCpp::Event::Modifiers
@@ -1,231 +1,136 @@
 #include "Track.h"
 
+#include "AdoCpp/FieldTable.h"
+#include "AdoCpp/JsonReader.h"
 #include "AdoCpp/Tile.h"
+#include "Fields.h"
 
 
 namespace AdoCpp::Event::Track
 {
-    ColorTrack::ColorTrack(const rapidjson::Value& data) : StaticEvent(data)
+    namespace
     {
-        trackColor = Color(data["trackColor"].GetString());
-        secondaryTrackColor = Color(data["secondaryTrackColor"].GetString());
-        trackColorAnimDuration = data["trackColorAnimDuration"].GetDouble();
-        trackColorType = cstr2trackColorType(data["trackColorType"].GetString());
-        trackStyle = cstr2trackStyle(data["trackStyle"].GetString());
-        if (data.HasMember("trackColorPulse"))
-            trackColorPulse = cstr2trackColorPulse(data["trackColorPulse"].GetString());
-        if (data.HasMember("trackPulseLength"))
-            trackPulseLength = data["trackPulseLength"].GetUint();
-        if (data.HasMember("trackTexture"))
-            trackTexture = data["trackTexture"].GetString();
-        if (data.HasMember("trackGlowIntensity"))
-            trackGlowIntensity = data["trackGlowIntensity"].GetDouble();
-    }
-    std::unique_ptr<rapidjson::Value> ColorTrack::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-        if (!active)
-            val->AddMember("active", active, alloc);
-        rapidjson::Value trackColorValue;
-        const std::string trackColorStr = trackColor.toString(false, false, Color::ToStringAlphaMode::Auto);
-        trackColorValue.SetString(trackColorStr.c_str(), trackColorStr.length(), alloc);
-        val->AddMember("trackColor", trackColorValue, alloc);
-        rapidjson::Value secondaryTrackColorValue;
-        const std::string secondaryTrackColorStr = trackColor.toString(false, false, Color::ToStringAlphaMode::Auto);
-        secondaryTrackColorValue.SetString(secondaryTrackColorStr.c_str(), secondaryTrackColorStr.length(), alloc);
-        val->AddMember("secondaryTrackColor", secondaryTrackColorValue, alloc);
-        autoRemoveDecimalPart(*val, "trackColorAnimDuration", trackColorAnimDuration, alloc);
-        val->AddMember("trackColorType", rapidjson::StringRef(trackColorType2cstr(trackColorType)), alloc);
-        val->AddMember("trackColorPulse", rapidjson::StringRef(trackColorPulse2cstr(trackColorPulse)), alloc);
-        val->AddMember("trackPulseLength", trackPulseLength, alloc);
-        val->AddMember("trackStyle", rapidjson::StringRef(trackStyle2cstr(trackStyle)), alloc);
-        rapidjson::Value trackTextureValue;
-        trackTextureValue.SetString(trackTexture.c_str(), trackTexture.length(), alloc);
-        val->AddMember("trackTexture", trackTextureValue, alloc);
-        autoRemoveDecimalPart(*val, "trackGlowIntensity", trackGlowIntensity, alloc);
-        return val;
-    }
-    PositionTrack::PositionTrack(const rapidjson::Value& data) : StaticEvent(data)
-    {
-        if (data.HasMember("positionOffset"))
+        /**
+         * @brief A point whose null coordinates keep their values.
+         */
+        struct PartialPointCodec : DefaultCodec
         {
-            const auto posOff = data["positionOffset"].GetArray();
-            if (!posOff[0].IsNull())
-                positionOffset.x = posOff[0].GetDouble();
-            if (!posOff[1].IsNull())
-                positionOffset.y = posOff[1].GetDouble();
-        }
-        relativeTo = data.HasMember("relativeTo") ? RelativeIndex(data["relativeTo"]) : RelativeIndex(0, ThisTile);
-        rotation = data.HasMember("rotation") ? data["rotation"].GetDouble() : 0;
-        scale = data.HasMember("scale") ? data["scale"].GetDouble() : 100;
-        opacity = data.HasMember("opacity") ? data["opacity"].GetDouble() : 100;
-        justThisTile = data.HasMember("justThisTile") ? toBool(data["justThisTile"]) : false;
-        editorOnly = data.HasMember("editorOnly") ? toBool(data["editorOnly"]) : false;
-        if (data.HasMember("stickToFloors"))
-            stickToFloors = toBool(data["stickToFloors"]);
-    }
-    std::unique_ptr<rapidjson::Value> PositionTrack::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-        if (!active)
-            val->AddMember("active", active, alloc);
-        {
-            rapidjson::Value posOffVal(rapidjson::kArrayType);
-            if (static_cast<int>(positionOffset.x) == positionOffset.x)
-                posOffVal.PushBack(static_cast<int>(positionOffset.x), alloc);
-            else
-                posOffVal.PushBack(positionOffset.x, alloc);
-            if (static_cast<int>(positionOffset.y) == positionOffset.y)
-                posOffVal.PushBack(static_cast<int>(positionOffset.y), alloc);
-            else
-                posOffVal.PushBack(positionOffset.y, alloc);
-            val->AddMember("positionOffset", posOffVal, alloc);
-        }
-        val->AddMember("relativeTo", *relativeTo.intoJson(alloc), alloc);
-        autoRemoveDecimalPart(*val, "rotation", rotation, alloc);
-        autoRemoveDecimalPart(*val, "scale", scale, alloc);
-        autoRemoveDecimalPart(*val, "opacity", opacity, alloc);
-        val->AddMember("justThisTile", justThisTile, alloc);
-        val->AddMember("editorOnly", editorOnly, alloc);
-        if (stickToFloors)
-            val->AddMember("stickToFloors", *stickToFloors, alloc);
-        return val;
-    }
-    MoveTrack::MoveTrack(const rapidjson::Value& data) : DynamicEvent(data)
-    {
-        startTile = RelativeIndex(data["startTile"]);
-        endTile = RelativeIndex(data["endTile"]);
-        duration = data["duration"].GetDouble();
-        if (data.HasMember("positionOffset"))
-        {
-            if (!data["positionOffset"][0].IsNull())
-                positionOffset.first = data["positionOffset"][0].GetDouble();
-            if (!data["positionOffset"][1].IsNull())
-                positionOffset.second = data["positionOffset"][1].GetDouble();
-        }
-        if (data.HasMember("rotationOffset"))
-            rotationOffset = data["rotationOffset"].GetDouble();
-        if (data.HasMember("scale"))
-        {
-            if (data["scale"].IsArray())
+            using DefaultCodec::write;
+            bool read(JsonReader& reader, const std::string_view key, const rapidjson::Value& value,
+                      Vector2lf& out) const
             {
-                if (!data["scale"][0].IsNull())
-                    scale.first = data["scale"][0].GetDouble();
-                if (!data["scale"][1].IsNull())
-                    scale.second = data["scale"][1].GetDouble();
+                OptionalPoint point;
+                if (!reader.convert(key, value, point))
+                    return false;
+                if (point.first)
+                    out.x = *point.first;
+                if (point.second)
+                    out.y = *point.second;
+                return true;
             }
-            else
+            void write(JsonWriter& writer, const Vector2lf& point) const
             {
-                scale.first = scale.second = data["scale"].GetDouble();
+                writer.startArray();
+                writer.number(point.x);
+                writer.number(point.y);
+                writer.endArray();
             }
-        }
-        if (data.HasMember("opacity"))
-            opacity = data["opacity"].GetDouble();
-        ease = cstr2easing(data["ease"].GetString());
-    }
-    std::unique_ptr<rapidjson::Value> MoveTrack::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-        if (!active)
-            val->AddMember("active", active, alloc);
-        val->AddMember("startTile", *startTile.intoJson(alloc), alloc);
-        val->AddMember("endTile", *endTile.intoJson(alloc), alloc);
-        autoRemoveDecimalPart(*val, "duration", duration, alloc);
-        // ReSharper disable once CppLocalVariableMayBeConst
-        if (auto op = optionalPoint2json(positionOffset, alloc); op)
-            val->AddMember("positionOffset", *op, alloc);
-        if (rotationOffset)
-            autoRemoveDecimalPart(*val, "rotationOffset", *rotationOffset, alloc);
-        if (auto op = optionalPoint2json(scale, alloc); op)
-            val->AddMember("scale", *op, alloc);
-        if (opacity)
-            autoRemoveDecimalPart(*val, "opacity", *opacity, alloc);
-        autoRemoveDecimalPart(*val, "angleOffset", angleOffset, alloc);
-        val->AddMember("ease", rapidjson::StringRef(easing2cstr(ease)), alloc);
-        addTag(*val, eventTag, alloc);
-        return val;
-    }
-    AnimateTrack::AnimateTrack(const rapidjson::Value& data) : StaticEvent(data)
-    {
-        if (data.HasMember("trackAnimation"))
-            trackAnimation = cstr2trackAnimation(data["trackAnimation"].GetString());
-        beatsAhead = data["beatsAhead"].GetDouble();
-        if (data.HasMember("trackDisappearAnimation"))
-            trackDisappearAnimation = cstr2trackDisappearAnimation(data["trackDisappearAnimation"].GetString());
-        beatsBehind = data["beatsBehind"].GetDouble();
-    }
-    std::unique_ptr<rapidjson::Value> AnimateTrack::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-        if (!active)
-            val->AddMember("active", active, alloc);
-        if (trackAnimation)
-            val->AddMember("trackAnimation", rapidjson::StringRef(trackAnimation2cstr(*trackAnimation)), alloc);
-        autoRemoveDecimalPart(*val, "beatsAhead", beatsAhead, alloc);
-        if (trackDisappearAnimation)
-            val->AddMember("trackDisappearAnimation",
-                          rapidjson::StringRef(trackDisappearAnimation2cstr(*trackDisappearAnimation)), alloc);
-        autoRemoveDecimalPart(*val, "beatsBehind", beatsBehind, alloc);
-        return val;
-    }
-    RecolorTrack::RecolorTrack(const rapidjson::Value& data) : DynamicEvent(data)
-    {
-        startTile = RelativeIndex(data["startTile"]);
-        endTile = RelativeIndex(data["endTile"]);
-        if (data.HasMember("duration"))
-            duration = data["duration"].GetDouble();
-        trackColorType = cstr2trackColorType(data["trackColorType"].GetString());
-        trackColor = Color(data["trackColor"].GetString());
-        secondaryTrackColor = Color(data["secondaryTrackColor"].GetString());
-        trackColorAnimDuration = data["trackColorAnimDuration"].GetDouble();
-        trackColorPulse = cstr2trackColorPulse(data["trackColorPulse"].GetString());
-        trackPulseLength = data["trackPulseLength"].GetUint();
-        trackStyle = cstr2trackStyle(data["trackStyle"].GetString());
-        if (data.HasMember("gapLength"))
-            gapLength = data["gapLength"].GetDouble();
-        if (data.HasMember("ease"))
-            ease = cstr2easing(data["ease"].GetString());
-        if (data.HasMember("trackGlowIntensity"))
-            trackGlowIntensity = data["trackGlowIntensity"].GetDouble();
-    }
-    std::unique_ptr<rapidjson::Value> RecolorTrack::intoJson(rapidjson::Document::AllocatorType& alloc) const
-    {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("floor", floor, alloc);
-        val->AddMember("eventType", rapidjson::StringRef(name()), alloc);
-        if (!active)
-            val->AddMember("active", active, alloc);
-        val->AddMember("startTile", *startTile.intoJson(alloc), alloc);
-        val->AddMember("endTile", *endTile.intoJson(alloc), alloc);
-        if (duration)
-            autoRemoveDecimalPart(*val, "duration", *duration, alloc);
-        val->AddMember("trackColorType", rapidjson::StringRef(trackColorType2cstr(trackColorType)), alloc);
-        rapidjson::Value trackColorValue;
-        const std::string trackColorStr = trackColor.toString(false, false, Color::ToStringAlphaMode::Auto);
-        trackColorValue.SetString(trackColorStr.c_str(), trackColorStr.length(), alloc);
-        val->AddMember("trackColor", trackColorValue, alloc);
-        rapidjson::Value secondaryTrackColorValue;
-        const std::string secondaryTrackColorStr = trackColor.toString(false, false, Color::ToStringAlphaMode::Auto);
-        secondaryTrackColorValue.SetString(secondaryTrackColorStr.c_str(), secondaryTrackColorStr.length(), alloc);
-        val->AddMember("secondaryTrackColor", secondaryTrackColorValue, alloc);
-        autoRemoveDecimalPart(*val, "trackColorAnimDuration", trackColorAnimDuration, alloc);
-        val->AddMember("trackColorPulse", rapidjson::StringRef(trackColorPulse2cstr(trackColorPulse)), alloc);
-        val->AddMember("trackPulseLength", trackPulseLength, alloc);
-        val->AddMember("trackStyle", rapidjson::StringRef(trackStyle2cstr(trackStyle)), alloc);
-        autoRemoveDecimalPart(*val, "trackColorAnimDuration", trackColorAnimDuration, alloc);
-        autoRemoveDecimalPart(*val, "gapLength", gapLength, alloc);
-        val->AddMember("ease", rapidjson::StringRef(easing2cstr(ease)), alloc);
-        autoRemoveDecimalPart(*val, "trackGlowIntensity", trackGlowIntensity, alloc);
-        addTag(*val, eventTag, alloc);
-        autoRemoveDecimalPart(*val, "angleOffset", angleOffset, alloc);
-        return val;
-    }
+        };
+        /**
+         * @brief A scale that is either a point or a single number for both axes.
+         */
+        struct ScaleCodec : DefaultCodec
+        {
+            bool read(JsonReader& reader, const std::string_view key, const rapidjson::Value& value,
+                      OptionalPoint& out) const
+            {
+                if (value.IsNumber())
+                {
+                    out.first = out.second = value.GetDouble();
+                    return true;
+                }
+                return reader.convert(key, value, out);
+            }
+        };
+
+        // clang-format off
+        constexpr EnumCodec trackColorTypeCodec{tryCstr2trackColorType, trackColorType2cstr};
+        constexpr EnumCodec trackColorPulseCodec{tryCstr2trackColorPulse, trackColorPulse2cstr};
+        constexpr EnumCodec trackStyleCodec{tryCstr2trackStyle, trackStyle2cstr};
+        constexpr EnumCodec trackAnimationCodec{tryCstr2trackAnimation, trackAnimation2cstr};
+        constexpr EnumCodec trackDisappearAnimationCodec{tryCstr2trackDisappearAnimation,
+                                                         trackDisappearAnimation2cstr};
+        constexpr EnumCodec easingCodec{tryCstr2easing, easing2cstr};
+
+        constexpr FieldTable colorTrackFields(std::tuple_cat(eventFields, std::tuple{
+            field("trackColor",             &ColorTrack::trackColor),
+            field("secondaryTrackColor",    &ColorTrack::secondaryTrackColor),
+            field("trackColorAnimDuration", &ColorTrack::trackColorAnimDuration),
+            field("trackColorType",         &ColorTrack::trackColorType, Required, trackColorTypeCodec),
+            field("trackColorPulse",        &ColorTrack::trackColorPulse, Optional, trackColorPulseCodec),
+            field("trackPulseLength",       &ColorTrack::trackPulseLength, Optional),
+            field("trackStyle",             &ColorTrack::trackStyle, Required, trackStyleCodec),
+            field("trackTexture",           &ColorTrack::trackTexture, Optional),
+            field("trackGlowIntensity",     &ColorTrack::trackGlowIntensity, Optional),
+        }));
+        constexpr FieldTable positionTrackFields(std::tuple_cat(eventFields, std::tuple{
+            field("positionOffset",        &PositionTrack::positionOffset, Optional, PartialPointCodec{}),
+            defaultedField("relativeTo",   &PositionTrack::relativeTo, RelativeIndex(0, ThisTile)),
+            defaultedField("rotation",     &PositionTrack::rotation, 0.0),
+            defaultedField("scale",        &PositionTrack::scale, 100.0),
+            defaultedField("opacity",      &PositionTrack::opacity, 100.0),
+            defaultedField("justThisTile", &PositionTrack::justThisTile, false),
+            defaultedField("editorOnly",   &PositionTrack::editorOnly, false),
+            field("stickToFloors",         &PositionTrack::stickToFloors, Optional),
+        }));
+        constexpr FieldTable moveTrackFields(std::tuple_cat(dynamicEventFields, std::tuple{
+            field("startTile",      &MoveTrack::startTile),
+            field("endTile",        &MoveTrack::endTile),
+            field("duration",       &MoveTrack::duration),
+            field("positionOffset", &MoveTrack::positionOffset, Optional),
+            field("rotationOffset", &MoveTrack::rotationOffset, Optional),
+            field("scale",          &MoveTrack::scale, Optional, ScaleCodec{}),
+            field("opacity",        &MoveTrack::opacity, Optional),
+            field("ease",           &MoveTrack::ease, Required, easingCodec),
+        }));
+        constexpr FieldTable animateTrackFields(std::tuple_cat(eventFields, std::tuple{
+            field("trackAnimation",          &AnimateTrack::trackAnimation, Optional, trackAnimationCodec),
+            field("beatsAhead",              &AnimateTrack::beatsAhead),
+            field("trackDisappearAnimation", &AnimateTrack::trackDisappearAnimation, Optional,
+                  trackDisappearAnimationCodec),
+            field("beatsBehind",             &AnimateTrack::beatsBehind),
+        }));
+        constexpr FieldTable recolorTrackFields(std::tuple_cat(dynamicEventFields, std::tuple{
+            field("startTile",              &RecolorTrack::startTile),
+            field("endTile",                &RecolorTrack::endTile),
+            field("duration",               &RecolorTrack::duration, Optional),
+            field("trackColorType",         &RecolorTrack::trackColorType, Required, trackColorTypeCodec),
+            field("trackColor",             &RecolorTrack::trackColor),
+            field("secondaryTrackColor",    &RecolorTrack::secondaryTrackColor),
+            field("trackColorAnimDuration", &RecolorTrack::trackColorAnimDuration),
+            field("trackColorPulse",        &RecolorTrack::trackColorPulse, Required, trackColorPulseCodec),
+            field("trackPulseLength",       &RecolorTrack::trackPulseLength),
+            field("trackStyle",             &RecolorTrack::trackStyle, Required, trackStyleCodec),
+            field("gapLength",              &RecolorTrack::gapLength, Optional),
+            field("ease",                   &RecolorTrack::ease, Optional, easingCodec),
+            field("trackGlowIntensity",     &RecolorTrack::trackGlowIntensity, Optional),
+        }));
+        // clang-format on
+    } // namespace
+
+    ColorTrack::ColorTrack(const rapidjson::Value& data) { readOrThrow(data); }
+    void ColorTrack::read(JsonReader& reader) { colorTrackFields.read(reader, *this); }
+    void ColorTrack::write(JsonWriter& writer) const { writeAction(writer, *this, colorTrackFields); }
+    PositionTrack::PositionTrack(const rapidjson::Value& data) { readOrThrow(data); }
+    void PositionTrack::read(JsonReader& reader) { positionTrackFields.read(reader, *this); }
+    void PositionTrack::write(JsonWriter& writer) const { writeAction(writer, *this, positionTrackFields); }
+    MoveTrack::MoveTrack(const rapidjson::Value& data) { readOrThrow(data); }
+    void MoveTrack::read(JsonReader& reader) { moveTrackFields.read(reader, *this); }
+    void MoveTrack::write(JsonWriter& writer) const { writeAction(writer, *this, moveTrackFields); }
+    AnimateTrack::AnimateTrack(const rapidjson::Value& data) { readOrThrow(data); }
+    void AnimateTrack::read(JsonReader& reader) { animateTrackFields.read(reader, *this); }
+    void AnimateTrack::write(JsonWriter& writer) const { writeAction(writer, *this, animateTrackFields); }
+    RecolorTrack::RecolorTrack(const rapidjson::Value& data) { readOrThrow(data); }
+    void RecolorTrack::read(JsonReader& reader) { recolorTrackFields.read(reader, *this); }
+    void RecolorTrack::write(JsonWriter& writer) const { writeAction(writer, *this, recolorTrackFields); }
 } // namespace AdoCpp::Event::Track
@@ -16,8 +16,8 @@ namespace AdoCpp::Event::Track
         [[nodiscard]] constexpr bool stackable() const noexcept override { return false; }
         [[nodiscard]] constexpr const char* name() const noexcept override { return "ColorTrack"; }
         [[nodiscard]] constexpr ColorTrack* clone() const override { return new ColorTrack(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
         TrackColorType trackColorType{};
         Color trackColor;
         Color secondaryTrackColor;
@@ -36,8 +36,8 @@ namespace AdoCpp::Event::Track
         [[nodiscard]] constexpr bool stackable() const noexcept override { return false; }
         [[nodiscard]] constexpr const char* name() const noexcept override { return "AnimateTrack"; }
         [[nodiscard]] constexpr AnimateTrack* clone() const override { return new AnimateTrack(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
         std::optional<TrackAnimation> trackAnimation;
         double beatsAhead{};
         std::optional<TrackDisappearAnimation> trackDisappearAnimation;
@@ -51,8 +51,8 @@ namespace AdoCpp::Event::Track
         [[nodiscard]] constexpr bool stackable() const noexcept override { return true; }
         [[nodiscard]] constexpr const char* name() const noexcept override { return "RecolorTrack"; }
         [[nodiscard]] constexpr RecolorTrack* clone() const override { return new RecolorTrack(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
         RelativeIndex startTile;
         RelativeIndex endTile;
         double gapLength{};
@@ -75,8 +75,8 @@ namespace AdoCpp::Event::Track
         [[nodiscard]] constexpr bool stackable() const noexcept override { return false; }
         [[nodiscard]] constexpr const char* name() const noexcept override { return "PositionTrack"; }
         [[nodiscard]] constexpr PositionTrack* clone() const override { return new PositionTrack(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
         Vector2lf positionOffset;
         RelativeIndex relativeTo;
         double rotation{};
@@ -94,8 +94,8 @@ namespace AdoCpp::Event::Track
         [[nodiscard]] constexpr bool stackable() const noexcept override { return true; }
         [[nodiscard]] constexpr const char* name() const noexcept override { return "MoveTrack"; }
         [[nodiscard]] constexpr MoveTrack* clone() const override { return new MoveTrack(*this); }
-        [[nodiscard]] std::unique_ptr<rapidjson::Value>
-        intoJson(rapidjson::Document::AllocatorType& alloc) const override;
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
         RelativeIndex startTile;
         RelativeIndex endTile;
         double duration = 0;
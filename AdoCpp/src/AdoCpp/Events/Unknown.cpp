@@ -0,0 +1,33 @@
+#include "Unknown.h"
+
+#include <string_view>
+#include "AdoCpp/JsonReader.h"
+
+namespace AdoCpp::Event
+{
+    Unknown::Unknown(const rapidjson::Value& data) { readOrThrow(data); }
+    void Unknown::read(JsonReader& reader)
+    {
+        Event::read(reader);
+        if (!reader.read("eventType", eventType))
+            return;
+        members.clear();
+        for (const auto& member : reader.object().GetObject())
+        {
+            if (const std::string_view key(member.name.GetString(), member.name.GetStringLength());
+                key != "floor" && key != "eventType" && key != "active")
+                members.emplace_back(key, compactJson(member.value));
+        }
+    }
+    void Unknown::write(JsonWriter& writer) const
+    {
+        writer.startObject();
+        writeHeader(writer);
+        for (const auto& [key, json] : members)
+        {
+            writer.key(key);
+            writer.raw(json);
+        }
+        writer.endObject();
+    }
+} // namespace AdoCpp::Event
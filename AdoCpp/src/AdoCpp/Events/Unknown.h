@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+#include "Base.h"
+
+namespace AdoCpp::Event
+{
+    /**
+     * Only floor and active are decoded. The other members are kept as compact json and written back
+     * as they were, so saving a level does not drop the actions AdoCpp does not know.
+     * @brief An action whose eventType is not supported.
+     */
+    class Unknown final : public Event
+    {
+    public:
+        Unknown() = default;
+        explicit Unknown(const rapidjson::Value& data);
+        [[nodiscard]] constexpr bool stackable() const noexcept override { return true; }
+        [[nodiscard]] const char* name() const noexcept override { return eventType.c_str(); }
+        [[nodiscard]] Unknown* clone() const override { return new Unknown(*this); }
+        void write(JsonWriter& writer) const override;
+        void read(JsonReader& reader) override;
+        std::string eventType;
+        /**
+         * @brief The other members of the action: the key and the compact json of the value.
+         */
+        std::vector<std::pair<std::string, std::string>> members;
+    };
+} // namespace AdoCpp::Event
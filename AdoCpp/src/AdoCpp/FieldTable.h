@@ -0,0 +1,296 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "NameTable.h"
+
+namespace AdoCpp
+{
+    /**
+     * @brief How a field of a FieldTable is read and written.
+     */
+    enum FieldFlags : unsigned
+    {
+        Required = 0, //!< Reported if the member is missing.
+        Optional = 1, //!< Keeps its value (or is reset to its default) if the member is missing.
+        ReadOnly = 2, //!< Never written.
+    };
+
+    /**
+     * Doubles are written as integers when they have no decimal part (see JsonWriter::number()).
+     * @brief The codec of the fields whose type JsonReader converts directly.
+     */
+    struct DefaultCodec
+    {
+        template <typename T>
+        bool read(JsonReader& reader, const std::string_view key, const rapidjson::Value& value, T& out) const
+        {
+            return reader.convert(key, value, out);
+        }
+        void write(JsonWriter& writer, const double d) const { writer.number(d); }
+        void write(JsonWriter& writer, const Color& color) const
+        {
+            writer.string(color.toString(false, false, Color::ToStringAlphaMode::Auto));
+        }
+        void write(JsonWriter& writer, const RelativeIndex& index) const { index.write(writer); }
+        void write(JsonWriter& writer, const OptionalPoint& point) const
+        {
+            writer.startArray();
+            for (const auto& coordinate : {point.first, point.second})
+            {
+                if (coordinate)
+                    writer.number(*coordinate);
+                else
+                    writer.null();
+            }
+            writer.endArray();
+        }
+        void write(JsonWriter& writer, const std::vector<std::string>& tags) const
+        {
+            char buffer[1145]{};
+            tags2cstr(tags, buffer, 1145);
+            writer.string(buffer);
+        }
+        template <typename T>
+            requires(std::is_integral_v<T> || std::is_convertible_v<const T&, std::string_view>)
+        void write(JsonWriter& writer, const T& v) const
+        {
+            writer.value(v);
+        }
+        /**
+         * @brief Get whether a value is not written at all (a point without coordinates).
+         */
+        static bool omit(const OptionalPoint& point) { return !point.first && !point.second; }
+    };
+    /**
+     * @brief The codec of the doubles that are always written as reals.
+     */
+    struct RealCodec : DefaultCodec
+    {
+        using DefaultCodec::write;
+        void write(JsonWriter& writer, const double d) const { writer.real(d); }
+    };
+    /**
+     * @brief The codec of an enumeration written as the name of its enumerator.
+     * @tparam E The enumeration.
+     */
+    template <typename E>
+    struct EnumCodec
+    {
+        std::optional<E> (*parse)(std::string_view) noexcept; //!< e.g. tryCstr2easing
+        const char* (*print)(const E&); //!< e.g. easing2cstr
+
+        bool read(JsonReader& reader, const std::string_view key, const rapidjson::Value& value, E& out) const
+        {
+            std::string_view name;
+            if (!reader.convert(key, value, name))
+                return false;
+            const std::optional<E> e = parse(name);
+            if (!e)
+            {
+                reader.fail(key, "has an invalid value");
+                return false;
+            }
+            out = *e;
+            return true;
+        }
+        void write(JsonWriter& writer, const E& e) const { writer.string(print(e)); }
+    };
+    template <typename E>
+    EnumCodec(std::optional<E> (*)(std::string_view) noexcept, const char* (*)(const E&)) -> EnumCodec<E>;
+
+    /**
+     * @brief The default of a field that has none.
+     */
+    struct NoDefault
+    {
+    };
+    /**
+     * @brief A member of a class as a member of a json object.
+     * @tparam Class The class (or the base class) that has the member.
+     * @tparam T The type of the member.
+     * @tparam Codec How the value is read and written (of T, or of T::value_type for a std::optional).
+     * @tparam Default The type of the default, or NoDefault.
+     */
+    template <typename Class, typename T, typename Codec, typename Default>
+    struct Field
+    {
+        const char* name;
+        T Class::*member;
+        unsigned flags;
+        Codec codec;
+        Default defaultValue;
+    };
+    /**
+     * @brief Describe a field.
+     * @param name The name of the json member.
+     * @param member The member.
+     * @param flags See FieldFlags.
+     * @param codec How the value is read and written.
+     */
+    template <typename Class, typename T, typename Codec = DefaultCodec>
+    consteval auto field(const char* name, T Class::*member, const unsigned flags = Required, Codec codec = {})
+    {
+        return Field<Class, T, Codec, NoDefault>{name, member, flags, codec, {}};
+    }
+    /**
+     * @brief Describe an optional field that is reset to a default before reading.
+     * @param name The name of the json member.
+     * @param member The member.
+     * @param defaultValue The value the member is reset to.
+     * @param codec How the value is read and written.
+     */
+    template <typename Class, typename T, typename Default, typename Codec = DefaultCodec>
+    consteval auto defaultedField(const char* name, T Class::*member, Default defaultValue, Codec codec = {})
+    {
+        return Field<Class, T, Codec, Default>{name, member, Optional, codec, defaultValue};
+    }
+
+    /**
+     * @brief Whether a type is a std::optional (whose fields are written only if they have a value).
+     */
+    template <typename T>
+    constexpr bool isOptional = false;
+    template <typename T>
+    constexpr bool isOptional<std::optional<T>> = true;
+
+    /**
+     * Reading walks the members of the json object once and finds each one's field with a perfect hash
+     * (see NameTable), instead of looking every field up in the object. The first of duplicate members wins,
+     * and the fields that are required but missing are reported at the end. Writing follows the order of the table.
+     * @brief The fields of a class, read from and written as a json object.
+     * @tparam Fields The Field types.
+     */
+    template <typename... Fields>
+    class FieldTable
+    {
+        static constexpr size_t N = sizeof...(Fields);
+
+    public:
+        /**
+         * @brief Constructor.
+         * @param fields The fields (see field() and defaultedField()).
+         */
+        consteval explicit FieldTable(const std::tuple<Fields...>& fields) : m_fields(fields), m_names(names(fields))
+        {
+        }
+
+        /**
+         * @brief Read the fields of an object.
+         * @param reader The reader of the json object.
+         * @param object The object.
+         */
+        template <typename Object>
+        void read(JsonReader& reader, Object& object) const
+        {
+            std::apply([&object](const auto&... field) { (resetToDefault(field, object), ...); }, m_fields);
+            if (!reader.object().IsObject())
+                return; // reported by the reader
+            std::array<bool, N> seen{};
+            for (const auto& member : reader.object().GetObject())
+            {
+                const std::string_view key(member.name.GetString(), member.name.GetStringLength());
+                if (const auto index = m_names.find(key); index && !seen[*index])
+                {
+                    seen[*index] = true;
+                    readers<Object>[*index](*this, reader, member.value, object);
+                }
+            }
+            [this, &reader, &seen]<size_t... I>(std::index_sequence<I...>)
+            {
+                ((!seen[I] && !(std::get<I>(m_fields).flags & Optional)
+                      ? reader.fail(std::get<I>(m_fields).name, "is missing")
+                      : void()),
+                 ...);
+            }(std::make_index_sequence<N>{});
+        }
+        /**
+         * @brief Write the fields of an object as members (without starting or ending the json object).
+         * @param writer The writer.
+         * @param object The object.
+         */
+        template <typename Object>
+        void write(JsonWriter& writer, const Object& object) const
+        {
+            std::apply([&writer, &object](const auto&... field) { (writeField(field, writer, object), ...); },
+                       m_fields);
+        }
+
+    private:
+        static consteval NameTable<N> names(const std::tuple<Fields...>& fields)
+        {
+            const char* names[N]{};
+            size_t i = 0;
+            std::apply([&names, &i](const auto&... field) { ((names[i++] = field.name), ...); }, fields);
+            return NameTable<N>(names);
+        }
+
+        template <typename Field, typename Object>
+        static void resetToDefault(const Field& field, Object& object)
+        {
+            if constexpr (!std::is_same_v<std::remove_cvref_t<decltype(field.defaultValue)>, NoDefault>)
+                object.*field.member = field.defaultValue;
+        }
+        template <typename Field, typename Object>
+        static void readField(const Field& field, JsonReader& reader, const rapidjson::Value& value, Object& object)
+        {
+            auto& out = object.*field.member;
+            if constexpr (isOptional<std::remove_cvref_t<decltype(out)>>)
+            {
+                typename std::remove_cvref_t<decltype(out)>::value_type v{};
+                if (field.codec.read(reader, field.name, value, v))
+                    out = std::move(v);
+            }
+            else
+                field.codec.read(reader, field.name, value, out);
+        }
+        template <typename Field, typename Object>
+        static void writeField(const Field& field, JsonWriter& writer, const Object& object)
+        {
+            if (field.flags & ReadOnly)
+                return;
+            const auto& value = object.*field.member;
+            if constexpr (isOptional<std::remove_cvref_t<decltype(value)>>)
+            {
+                if (!value)
+                    return;
+                writer.key(field.name);
+                field.codec.write(writer, *value);
+            }
+            else
+            {
+                if constexpr (requires { field.codec.omit(value); })
+                    if (field.codec.omit(value))
+                        return;
+                writer.key(field.name);
+                field.codec.write(writer, value);
+            }
+        }
+
+        template <typename Object>
+        using Reader = void (*)(const FieldTable&, JsonReader&, const rapidjson::Value&, Object&);
+        /**
+         * @brief The reader of each field, indexed like the names.
+         */
+        template <typename Object>
+        static constexpr auto readers = []<size_t... I>(std::index_sequence<I...>)
+        {
+            return std::array<Reader<Object>, N>{
+                [](const FieldTable& table, JsonReader& reader, const rapidjson::Value& value, Object& object)
+                { readField(std::get<I>(table.m_fields), reader, value, object); }...};
+        }(std::make_index_sequence<N>{});
+
+        std::tuple<Fields...> m_fields;
+        NameTable<N> m_names;
+    };
+} // namespace AdoCpp
@@ -0,0 +1,160 @@
+#include "JsonReader.h"
+
+namespace AdoCpp
+{
+    JsonReader::JsonReader(const rapidjson::Value& object) : m_object(object)
+    {
+        if (!m_object.IsObject())
+            m_error = "not an object";
+    }
+    void JsonReader::fail(const std::string_view key, const std::string_view reason)
+    {
+        if (!m_error.empty())
+            m_error += "; ";
+        m_error += key;
+        m_error += ' ';
+        m_error += reason;
+    }
+    const rapidjson::Value* JsonReader::find(const std::string_view key) const noexcept
+    {
+        if (!m_object.IsObject())
+            return nullptr;
+        const rapidjson::Value name(rapidjson::StringRef(key.data(), key.size()));
+        const auto member = m_object.FindMember(name);
+        return member == m_object.MemberEnd() ? nullptr : &member->value;
+    }
+
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, double& out)
+    {
+        if (!value.IsNumber())
+        {
+            fail(key, "is not a number");
+            return false;
+        }
+        out = value.GetDouble();
+        return true;
+    }
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, int64_t& out)
+    {
+        if (!value.IsInt64())
+        {
+            fail(key, "is not an integer");
+            return false;
+        }
+        out = value.GetInt64();
+        return true;
+    }
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, uint64_t& out)
+    {
+        if (!value.IsUint64())
+        {
+            fail(key, "is not a non-negative integer");
+            return false;
+        }
+        out = value.GetUint64();
+        return true;
+    }
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, uint32_t& out)
+    {
+        if (!value.IsUint())
+        {
+            fail(key, "is not a non-negative integer");
+            return false;
+        }
+        out = value.GetUint();
+        return true;
+    }
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, bool& out)
+    {
+        // Same as toBool().
+        if (value.IsBool())
+        {
+            out = value.GetBool();
+            return true;
+        }
+        if (value.IsString())
+        {
+            if (const std::string_view str(value.GetString(), value.GetStringLength()); str == "Enabled")
+            {
+                out = true;
+                return true;
+            }
+            else if (str == "Disabled")
+            {
+                out = false;
+                return true;
+            }
+        }
+        fail(key, R"(is not a boolean or "Enabled" or "Disabled")");
+        return false;
+    }
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, std::string_view& out)
+    {
+        if (!value.IsString())
+        {
+            fail(key, "is not a string");
+            return false;
+        }
+        out = {value.GetString(), value.GetStringLength()};
+        return true;
+    }
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, std::string& out)
+    {
+        std::string_view str;
+        if (!convert(key, value, str))
+            return false;
+        out = str;
+        return true;
+    }
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, Color& out)
+    {
+        std::string_view str;
+        if (!convert(key, value, str))
+            return false;
+        const std::string_view digits = str.substr(!str.empty() && str[0] == '#');
+        if ((digits.size() != 6 && digits.size() != 8) ||
+            digits.find_first_not_of("0123456789ABCDEFabcdef") != std::string_view::npos)
+        {
+            fail(key, "is not a color");
+            return false;
+        }
+        out = Color(std::string(str));
+        return true;
+    }
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, RelativeIndex& out)
+    {
+        if (value.IsArray() && value.Size() >= 2 && value[0].IsInt64() && value[1].IsString())
+        {
+            if (const auto relativeTo = tryCstr2relativeToTile({value[1].GetString(), value[1].GetStringLength()}))
+            {
+                out = RelativeIndex(value[0].GetInt64(), *relativeTo);
+                return true;
+            }
+        }
+        fail(key, "is not a tile index");
+        return false;
+    }
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, OptionalPoint& out)
+    {
+        if (!value.IsArray() || value.Size() < 2 || !(value[0].IsNull() || value[0].IsNumber()) ||
+            !(value[1].IsNull() || value[1].IsNumber()))
+        {
+            fail(key, "is not a point");
+            return false;
+        }
+        // A null coordinate keeps its value.
+        if (!value[0].IsNull())
+            out.first = value[0].GetDouble();
+        if (!value[1].IsNull())
+            out.second = value[1].GetDouble();
+        return true;
+    }
+    bool JsonReader::convert(const std::string_view key, const rapidjson::Value& value, std::vector<std::string>& out)
+    {
+        std::string_view str;
+        if (!convert(key, value, str))
+            return false;
+        out = cstr2tags(std::string(str).c_str());
+        return true;
+    }
+} // namespace AdoCpp
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <rapidjson/document.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Color.h"
+#include "Utils.h"
+
+namespace AdoCpp
+{
+    /**
+     * Nothing throws: a member that is missing (when it is required) or that has the wrong type or value
+     * is reported and the field it would have been read into keeps its value. Check ok() afterwards.
+     * @brief Reads the members of a json object into C++ fields.
+     */
+    class JsonReader
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param object The json object (anything else is reported).
+         */
+        explicit JsonReader(const rapidjson::Value& object);
+
+        /**
+         * @brief Get the json object.
+         */
+        [[nodiscard]] const rapidjson::Value& object() const noexcept { return m_object; }
+        /**
+         * @brief Get whether nothing has been reported.
+         */
+        [[nodiscard]] bool ok() const noexcept { return m_error.empty(); }
+        /**
+         * @brief Get what has been reported, separated by "; ".
+         */
+        [[nodiscard]] const std::string& error() const noexcept { return m_error; }
+        /**
+         * @brief Report a problem with a member.
+         */
+        void fail(std::string_view key, std::string_view reason);
+
+        /**
+         * @brief Find a member.
+         * @return The value, or nullptr if the object does not have the member.
+         */
+        [[nodiscard]] const rapidjson::Value* find(std::string_view key) const noexcept;
+        [[nodiscard]] bool has(const std::string_view key) const noexcept { return find(key); }
+
+        /**
+         * @brief Read a required member.
+         * @return Whether it has been read.
+         */
+        template <typename T>
+        bool read(const std::string_view key, T& out)
+        {
+            const auto value = find(key);
+            if (!value)
+            {
+                if (m_object.IsObject()) // otherwise it has been reported already
+                    fail(key, "is missing");
+                return false;
+            }
+            return convert(key, *value, out);
+        }
+        /**
+         * @brief Read a member if the object has it.
+         * @return Whether it has been read.
+         */
+        template <typename T>
+        bool readIfPresent(const std::string_view key, T& out)
+        {
+            const auto value = find(key);
+            return value && convert(key, *value, out);
+        }
+        template <typename T>
+        bool readIfPresent(const std::string_view key, std::optional<T>& out)
+        {
+            T t{};
+            if (!readIfPresent(key, t))
+                return false;
+            out = std::move(t);
+            return true;
+        }
+        /**
+         * @brief Read a required member that is the name of an enumerator.
+         * @param parse The function that converts the name (e.g. tryCstr2easing).
+         * @return Whether it has been read.
+         */
+        template <typename E, typename Parse>
+        bool read(const std::string_view key, E& out, Parse parse)
+        {
+            std::string_view name;
+            if (!read(key, name))
+                return false;
+            return convert(key, name, out, parse);
+        }
+        template <typename E, typename Parse>
+        bool readIfPresent(const std::string_view key, E& out, Parse parse)
+        {
+            std::string_view name;
+            if (!readIfPresent(key, name))
+                return false;
+            return convert(key, name, out, parse);
+        }
+        template <typename E, typename Parse>
+        bool readIfPresent(const std::string_view key, std::optional<E>& out, Parse parse)
+        {
+            E e{};
+            if (!readIfPresent(key, e, parse))
+                return false;
+            out = e;
+            return true;
+        }
+
+        /**
+         * @brief Convert the value of a member, reporting it if it has the wrong type or value.
+         * @return Whether it has been converted (out is left as it was otherwise).
+         */
+        // clang-format off
+        bool convert(std::string_view key, const rapidjson::Value& value, double& out);
+        bool convert(std::string_view key, const rapidjson::Value& value, int64_t& out);
+        bool convert(std::string_view key, const rapidjson::Value& value, uint64_t& out);
+        bool convert(std::string_view key, const rapidjson::Value& value, uint32_t& out);
+        bool convert(std::string_view key, const rapidjson::Value& value, bool& out);
+        bool convert(std::string_view key, const rapidjson::Value& value, std::string_view& out);
+        bool convert(std::string_view key, const rapidjson::Value& value, std::string& out);
+        bool convert(std::string_view key, const rapidjson::Value& value, Color& out);
+        bool convert(std::string_view key, const rapidjson::Value& value, RelativeIndex& out);
+        bool convert(std::string_view key, const rapidjson::Value& value, OptionalPoint& out);
+        /**
+         * @brief Read tags (a string of names separated by spaces).
+         */
+        bool convert(std::string_view key, const rapidjson::Value& value, std::vector<std::string>& out);
+        // clang-format on
+
+    private:
+        template <typename E, typename Parse>
+        bool convert(const std::string_view key, const std::string_view name, E& out, Parse parse)
+        {
+            const std::optional<E> e = parse(name);
+            if (!e)
+            {
+                fail(key, "has an invalid value");
+                return false;
+            }
+            out = *e;
+            return true;
+        }
+
+        const rapidjson::Value& m_object;
+        std::string m_error;
+    };
+} // namespace AdoCpp
@@ -0,0 +1,97 @@
+#include "JsonWriter.h"
+
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+#include <rapidjson/writer.h>
+
+#include "ExactNumbers.h"
+
+namespace AdoCpp
+{
+    namespace
+    {
+        /**
+         * @brief A rapidjson SAX handler that forwards to a JsonWriter.
+         */
+        class JsonWriterHandler
+        {
+        public:
+            explicit JsonWriterHandler(JsonWriter& writer) : m_writer(writer) {}
+
+            // clang-format off
+            bool Null() { m_writer.null(); return true; }
+            bool Bool(const bool b) { m_writer.boolean(b); return true; }
+            bool Int(const int i) { m_writer.int64(i); return true; }
+            bool Uint(const unsigned u) { m_writer.uint64(u); return true; }
+            bool Int64(const int64_t i) { m_writer.int64(i); return true; }
+            bool Uint64(const uint64_t u) { m_writer.uint64(u); return true; }
+            bool Double(const double d) { m_writer.real(d); return true; }
+            bool RawNumber(const char* str, const rapidjson::SizeType length, bool) { return parseNumber(*this, str, length); }
+            bool String(const char* str, const rapidjson::SizeType length, bool) { m_writer.string({str, length}); return true; }
+            bool StartObject() { m_writer.startObject(); return true; }
+            bool Key(const char* str, const rapidjson::SizeType length, bool) { m_writer.key({str, length}); return true; }
+            bool EndObject(rapidjson::SizeType) { m_writer.endObject(); return true; }
+            bool StartArray() { m_writer.startArray(); return true; }
+            bool EndArray(rapidjson::SizeType) { m_writer.endArray(); return true; }
+            // clang-format on
+
+        private:
+            JsonWriter& m_writer;
+        };
+    } // namespace
+
+    void JsonWriter::raw(const std::string_view json)
+    {
+        JsonWriterHandler handler(*this);
+        rapidjson::Reader reader;
+        rapidjson::MemoryStream ms(json.data(), json.size());
+        reader.Parse<rapidjson::kParseNumbersAsStringsFlag>(ms, handler);
+    }
+    void JsonWriter::json(const rapidjson::Value& value)
+    {
+        JsonWriterHandler handler(*this);
+        value.Accept(handler);
+    }
+    std::string compactJson(const rapidjson::Value& value)
+    {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer writer(buffer);
+        value.Accept(writer);
+        return {buffer.GetString(), buffer.GetSize()};
+    }
+
+    void JsonValueWriter::null() { add(rapidjson::Value(rapidjson::kNullType)); }
+    void JsonValueWriter::boolean(const bool b) { add(rapidjson::Value(b)); }
+    void JsonValueWriter::int64(const int64_t i) { add(rapidjson::Value(i)); }
+    void JsonValueWriter::uint64(const uint64_t u) { add(rapidjson::Value(u)); }
+    void JsonValueWriter::real(const double d) { add(rapidjson::Value(d)); }
+    void JsonValueWriter::string(const std::string_view str)
+    {
+        add(rapidjson::Value(str.data(), static_cast<rapidjson::SizeType>(str.size()), m_alloc));
+    }
+    void JsonValueWriter::key(const std::string_view str)
+    {
+        m_key.SetString(str.data(), static_cast<rapidjson::SizeType>(str.size()), m_alloc);
+    }
+    void JsonValueWriter::startObject() { m_stack.emplace_back(std::move(m_key), rapidjson::kObjectType); }
+    void JsonValueWriter::endObject() { close(); }
+    void JsonValueWriter::startArray() { m_stack.emplace_back(std::move(m_key), rapidjson::kArrayType); }
+    void JsonValueWriter::endArray() { close(); }
+
+    void JsonValueWriter::add(rapidjson::Value value)
+    {
+        if (m_stack.empty())
+            m_value = std::move(value);
+        else if (auto& container = m_stack.back().second; container.IsObject())
+            container.AddMember(m_key, value, m_alloc);
+        else
+            container.PushBack(value, m_alloc);
+    }
+    void JsonValueWriter::close()
+    {
+        auto [key, container] = std::move(m_stack.back());
+        m_stack.pop_back();
+        m_key = std::move(key);
+        add(std::move(container));
+    }
+} // namespace AdoCpp
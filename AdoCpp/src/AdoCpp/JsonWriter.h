@@ -0,0 +1,341 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace AdoCpp
+{
+    /**
+     * Levels, settings and events are written through this interface, so the same code can stream
+     * json text into any rapidjson writer (see RapidJsonWriter) or build a rapidjson value (see JsonValueWriter).
+     * @brief An output for json tokens.
+     */
+    class JsonWriter
+    {
+    public:
+        virtual ~JsonWriter() = default;
+
+        virtual void null() = 0;
+        virtual void boolean(bool b) = 0;
+        virtual void int64(int64_t i) = 0;
+        virtual void uint64(uint64_t u) = 0;
+        virtual void real(double d) = 0;
+        virtual void string(std::string_view str) = 0;
+        virtual void key(std::string_view str) = 0;
+        virtual void startObject() = 0;
+        virtual void endObject() = 0;
+        virtual void startArray() = 0;
+        virtual void endArray() = 0;
+        /**
+         * @brief Write a value given as json text (e.g. kept by compactJson()).
+         * @param json The json text of one value.
+         */
+        virtual void raw(std::string_view json);
+        /**
+         * @brief Write a rapidjson value.
+         * @param value The value.
+         */
+        void json(const rapidjson::Value& value);
+
+        /**
+         * A chunk is a separate writer that can be used from another thread. The elements written into it are
+         * later appended to the array currently being written, with the same bytes as if they had been written here.
+         * @brief Create a writer for a chunk of the elements of the current array.
+         * @return The writer, or nullptr if chunks are not supported (see supportsChunks()).
+         */
+        [[nodiscard]] virtual std::unique_ptr<JsonWriter> newArrayChunk() const { return nullptr; }
+        /**
+         * @brief Append the elements of a chunk (see newArrayChunk()) to the current array.
+         * @param chunk The chunk.
+         */
+        virtual void appendArrayChunk(JsonWriter& /*chunk*/) {}
+        /**
+         * @brief Check whether newArrayChunk() creates chunks.
+         */
+        [[nodiscard]] virtual bool supportsChunks() const { return false; }
+
+        /**
+         * @brief Write a double, as an integer if it has no decimal part.
+         */
+        void number(const double d)
+        {
+            // Only a finite double in [-2^63, 2^63) can be cast to int64_t.
+            if (std::isfinite(d) && d >= -0x1p63 && d < 0x1p63 && static_cast<double>(static_cast<int64_t>(d)) == d)
+                int64(static_cast<int64_t>(d));
+            else
+                real(d);
+        }
+        /**
+         * @brief Write a value of a C++ type: bool, an integer, a floating point number or a string.
+         */
+        template <typename T>
+        void value(const T& v)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                boolean(v);
+            else if constexpr (std::is_floating_point_v<T>)
+                real(v);
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+                int64(v);
+            else if constexpr (std::is_integral_v<T>)
+                uint64(v);
+            else
+                string(std::string_view(v));
+        }
+        /**
+         * @brief Write a key and its value.
+         */
+        template <typename T>
+        void member(const std::string_view name, const T& v)
+        {
+            key(name);
+            value(v);
+        }
+        /**
+         * @brief Write a key and a double, as an integer if it has no decimal part.
+         */
+        void numberMember(const std::string_view name, const double d)
+        {
+            key(name);
+            number(d);
+        }
+    };
+
+    /**
+     * @brief Get the compact json text of a value (kept instead of the value, see JsonWriter::raw).
+     */
+    [[nodiscard]] std::string compactJson(const rapidjson::Value& value);
+
+    /**
+     * @brief The string buffer and the writer type a rapidjson Writer or PrettyWriter writes chunks with.
+     */
+    template <typename Writer>
+    struct RapidJsonBufferWriter
+    {
+    };
+    template <template <typename, typename, typename, typename, unsigned> class Writer, typename OutputStream,
+              typename SourceEncoding, typename TargetEncoding, typename StackAllocator, unsigned writeFlags>
+    struct RapidJsonBufferWriter<Writer<OutputStream, SourceEncoding, TargetEncoding, StackAllocator, writeFlags>>
+    {
+        using Buffer = rapidjson::GenericStringBuffer<TargetEncoding>;
+        using type = Writer<Buffer, SourceEncoding, TargetEncoding, StackAllocator, writeFlags>;
+    };
+
+    /**
+     * @brief Copy the settings of a rapidjson Writer or PrettyWriter to a writer of the same kind.
+     */
+    template <typename From, typename To>
+    void copyWriterSettings(const From& from, To& to)
+    {
+        to.SetMaxDecimalPlaces(from.GetMaxDecimalPlaces());
+        if constexpr (requires(To& writer) { writer.SetIndent(' ', 4u); })
+        {
+            // PrettyWriter has no getters for its indentation and format options.
+            struct Settings : From
+            {
+                using From::formatOptions_;
+                using From::indentChar_;
+                using From::indentCharCount_;
+            };
+            to.SetIndent(from.*&Settings::indentChar_, from.*&Settings::indentCharCount_);
+            to.SetFormatOptions(from.*&Settings::formatOptions_);
+        }
+    }
+
+    /**
+     * @brief A JsonWriter that forwards to a rapidjson Writer or PrettyWriter.
+     * @tparam Writer The type of the rapidjson writer.
+     */
+    template <typename Writer>
+    class RapidJsonWriter final : public JsonWriter
+    {
+    public:
+        explicit RapidJsonWriter(Writer& writer) : m_writer(writer) {}
+
+        void null() override { m_writer.Null(); }
+        void boolean(const bool b) override { m_writer.Bool(b); }
+        void int64(const int64_t i) override { m_writer.Int64(i); }
+        void uint64(const uint64_t u) override { m_writer.Uint64(u); }
+        void real(const double d) override { m_writer.Double(d); }
+        void string(const std::string_view str) override
+        {
+            m_writer.String(str.data(), static_cast<rapidjson::SizeType>(str.size()));
+        }
+        void key(const std::string_view str) override
+        {
+            m_writer.Key(str.data(), static_cast<rapidjson::SizeType>(str.size()));
+        }
+        void startObject() override
+        {
+            m_writer.StartObject();
+            m_depth++;
+        }
+        void endObject() override
+        {
+            m_writer.EndObject();
+            m_depth--;
+        }
+        void startArray() override
+        {
+            m_writer.StartArray();
+            m_depth++;
+        }
+        void endArray() override
+        {
+            m_writer.EndArray();
+            m_depth--;
+        }
+
+        /**
+         * The chunk writes into a string buffer with a writer of the same type and with the same settings.
+         */
+        [[nodiscard]] std::unique_ptr<JsonWriter> newArrayChunk() const override;
+        void appendArrayChunk(JsonWriter& chunk) override;
+        [[nodiscard]] bool supportsChunks() const override { return chunked; }
+
+    private:
+        static constexpr bool chunked = requires { typename RapidJsonBufferWriter<Writer>::type; };
+
+        Writer& m_writer;
+        /**
+         * @brief The number of open objects and arrays.
+         */
+        size_t m_depth = 0;
+    };
+
+    /**
+     * The chunk writer is first brought to the depth of the array with empty arrays and given two null elements:
+     * what is written between them is the separator of the elements, and the elements that follow are kept
+     * without their first separator, which the main writer writes when the chunk is appended.
+     * @brief A JsonWriter that writes the elements of an array into a string buffer.
+     * @tparam Writer The type of the rapidjson writer.
+     */
+    template <typename Writer>
+    class RapidJsonChunkWriter final : public JsonWriter
+    {
+    public:
+        using Buffer = typename RapidJsonBufferWriter<Writer>::Buffer;
+        using BufferWriter = typename RapidJsonBufferWriter<Writer>::type;
+
+        /**
+         * @brief Constructor.
+         * @param writer The main writer, whose settings are copied.
+         * @param depth The number of open objects and arrays in the main writer.
+         */
+        RapidJsonChunkWriter(const Writer& writer, const size_t depth) : m_writer(m_buffer)
+        {
+            copyWriterSettings(writer, m_writer);
+            for (size_t i = 0; i < depth; i++)
+                m_writer.StartArray();
+            m_writer.Null();
+            const size_t first = m_buffer.GetSize();
+            m_writer.Null();
+            m_begin = m_buffer.GetSize();
+            m_separatorLength = m_begin - first - 4; // "null"
+        }
+
+        void null() override { m_writer.Null(); }
+        void boolean(const bool b) override { m_writer.Bool(b); }
+        void int64(const int64_t i) override { m_writer.Int64(i); }
+        void uint64(const uint64_t u) override { m_writer.Uint64(u); }
+        void real(const double d) override { m_writer.Double(d); }
+        void string(const std::string_view str) override
+        {
+            m_writer.String(str.data(), static_cast<rapidjson::SizeType>(str.size()));
+        }
+        void key(const std::string_view str) override
+        {
+            m_writer.Key(str.data(), static_cast<rapidjson::SizeType>(str.size()));
+        }
+        void startObject() override { m_writer.StartObject(); }
+        void endObject() override { m_writer.EndObject(); }
+        void startArray() override { m_writer.StartArray(); }
+        void endArray() override { m_writer.EndArray(); }
+
+        /**
+         * @brief Get the elements that have been written, without the separator before the first one.
+         */
+        [[nodiscard]] std::basic_string_view<typename Buffer::Ch> elements() const
+        {
+            if (m_buffer.GetSize() == m_begin)
+                return {};
+            return {m_buffer.GetString() + m_begin + m_separatorLength,
+                    m_buffer.GetSize() - m_begin - m_separatorLength};
+        }
+
+    private:
+        Buffer m_buffer;
+        BufferWriter m_writer;
+        size_t m_begin;
+        size_t m_separatorLength;
+    };
+
+    template <typename Writer>
+    std::unique_ptr<JsonWriter> RapidJsonWriter<Writer>::newArrayChunk() const
+    {
+        if constexpr (chunked)
+            return std::make_unique<RapidJsonChunkWriter<Writer>>(m_writer, m_depth);
+        else
+            return nullptr;
+    }
+    template <typename Writer>
+    void RapidJsonWriter<Writer>::appendArrayChunk(JsonWriter& chunk)
+    {
+        if constexpr (chunked)
+        {
+            if (const auto elements = static_cast<RapidJsonChunkWriter<Writer>&>(chunk).elements(); !elements.empty())
+                m_writer.RawValue(elements.data(), elements.size(), rapidjson::kObjectType);
+        }
+    }
+
+    /**
+     * @brief A JsonWriter that builds a rapidjson value.
+     */
+    class JsonValueWriter final : public JsonWriter
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param alloc The allocator of the value (and its strings).
+         */
+        explicit JsonValueWriter(rapidjson::Document::AllocatorType& alloc) : m_alloc(alloc) {}
+
+        void null() override;
+        void boolean(bool b) override;
+        void int64(int64_t i) override;
+        void uint64(uint64_t u) override;
+        void real(double d) override;
+        void string(std::string_view str) override;
+        void key(std::string_view str) override;
+        void startObject() override;
+        void endObject() override;
+        void startArray() override;
+        void endArray() override;
+
+        /**
+         * @brief Take the value that has been written.
+         */
+        [[nodiscard]] rapidjson::Value take() { return std::move(m_value); }
+
+    private:
+        void add(rapidjson::Value value);
+        void close();
+
+        rapidjson::Document::AllocatorType& m_alloc;
+        /**
+         * @brief The open containers, each with the key it will be added under.
+         */
+        std::vector<std::pair<rapidjson::Value, rapidjson::Value>> m_stack;
+        rapidjson::Value m_key;
+        rapidjson::Value m_value;
+    };
+} // namespace AdoCpp
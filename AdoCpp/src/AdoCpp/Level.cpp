@@ -8,6 +8,11 @@
 #include <ranges>
 #include <rapidjson/prettywriter.h>
 
+#include "FieldTable.h"
+#include "LevelBinary.h"
+#include "LevelReader.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 #include "rapidjson/document.h"
 
@@ -20,111 +25,131 @@ constexpr double positiveRemainder(const double a, const double b)
 
 namespace AdoCpp
 {
-    Settings::Settings(const rapidjson::Value& jsonSettings) { *this = fromJson(jsonSettings); }
-    Settings Settings::fromJson(const rapidjson::Value& jsonSettings)
+    namespace
     {
-        Settings settings;
-
-        settings.artist = jsonSettings["artist"].GetString();
-        settings.song = jsonSettings["song"].GetString();
-        settings.author = jsonSettings["author"].GetString();
-        settings.separateCountdownTime = toBool(jsonSettings["separateCountdownTime"]);
-        settings.songFilename = jsonSettings["songFilename"].GetString();
-        settings.bpm = jsonSettings["bpm"].GetDouble();
-        settings.offset = jsonSettings["offset"].GetDouble();
-        settings.pitch = jsonSettings["pitch"].GetDouble();
-
-        settings.hitsound = cstr2hitsound(jsonSettings["hitsound"].GetString());
-        settings.hitsoundVolume =
-            jsonSettings[jsonSettings.HasMember("hitsoundVolume") ? "hitsoundVolume" : "hitsoundSingle"].GetDouble();
-
-        settings.countdownTicks =
-            jsonSettings.HasMember("countdownTicks") ? jsonSettings["countdownTicks"].GetDouble() : 4;
-
-        settings.trackColorType = cstr2trackColorType(jsonSettings["trackColorType"].GetString());
-        settings.trackColor = Color(jsonSettings["trackColor"].GetString());
-        settings.secondaryTrackColor = Color(jsonSettings["secondaryTrackColor"].GetString());
-        settings.trackColorAnimDuration = jsonSettings["trackColorAnimDuration"].GetDouble();
-        settings.trackColorPulse = cstr2trackColorPulse(jsonSettings["trackColorPulse"].GetString());
-        settings.trackPulseLength = jsonSettings["trackPulseLength"].GetUint();
-        settings.trackStyle = cstr2trackStyle(jsonSettings["trackStyle"].GetString());
-
-        settings.trackAnimation = cstr2trackAnimation(jsonSettings["trackAnimation"].GetString());
-        settings.beatsAhead = jsonSettings["beatsAhead"].GetDouble();
-        settings.trackDisappearAnimation =
-            cstr2trackDisappearAnimation(jsonSettings["trackDisappearAnimation"].GetString());
-        settings.beatsBehind = jsonSettings["beatsBehind"].GetDouble();
+        /**
+         * @brief The camera position of the settings, which needs both coordinates.
+         */
+        struct PositionCodec
+        {
+            bool read(JsonReader& reader, const std::string_view key, const rapidjson::Value& value,
+                      Vector2lf& out) const
+            {
+                OptionalPoint point;
+                if (!reader.convert(key, value, point))
+                    return false;
+                if (!point.first || !point.second)
+                {
+                    reader.fail(key, "has a null coordinate");
+                    return false;
+                }
+                out = Vector2lf(*point.first, *point.second);
+                return true;
+            }
+            void write(JsonWriter& writer, const Vector2lf& point) const
+            {
+                writer.startArray();
+                writer.real(point.x);
+                writer.real(point.y);
+                writer.endArray();
+            }
+        };
 
-        settings.backgroundColor = Color(jsonSettings["backgroundColor"].GetString());
+        // clang-format off
+        constexpr FieldTable settingsFields(std::tuple{
+            field("artist",                  &Settings::artist),
+            field("song",                    &Settings::song),
+            field("author",                  &Settings::author),
+            field("separateCountdownTime",   &Settings::separateCountdownTime),
+            defaultedField("countdownTicks", &Settings::countdownTicks, 4.0, RealCodec{}),
+            field("songFilename",            &Settings::songFilename),
+            field("bpm",                     &Settings::bpm, Required, RealCodec{}),
+            field("volume",                  &Settings::volume, Optional, RealCodec{}),
+            field("offset",                  &Settings::offset, Required, RealCodec{}),
+            field("pitch",                   &Settings::pitch, Required, RealCodec{}),
+            field("hitsound",                &Settings::hitsound, Required, EnumCodec{tryCstr2hitsound, hitsound2cstr}),
+            field("hitsoundVolume",          &Settings::hitsoundVolume, Optional, RealCodec{}),
+            field("trackColorType",          &Settings::trackColorType, Required,
+                  EnumCodec{tryCstr2trackColorType, trackColorType2cstr}),
+            field("trackColor",              &Settings::trackColor),
+            field("secondaryTrackColor",     &Settings::secondaryTrackColor),
+            field("trackColorAnimDuration",  &Settings::trackColorAnimDuration, Required, RealCodec{}),
+            field("trackColorPulse",         &Settings::trackColorPulse, Required,
+                  EnumCodec{tryCstr2trackColorPulse, trackColorPulse2cstr}),
+            field("trackPulseLength",        &Settings::trackPulseLength),
+            field("trackStyle",              &Settings::trackStyle, Required, EnumCodec{tryCstr2trackStyle, trackStyle2cstr}),
+            field("trackAnimation",          &Settings::trackAnimation, Required,
+                  EnumCodec{tryCstr2trackAnimation, trackAnimation2cstr}),
+            field("beatsAhead",              &Settings::beatsAhead, Required, RealCodec{}),
+            field("trackDisappearAnimation", &Settings::trackDisappearAnimation, Required,
+                  EnumCodec{tryCstr2trackDisappearAnimation, trackDisappearAnimation2cstr}),
+            field("beatsBehind",             &Settings::beatsBehind, Required, RealCodec{}),
+            field("backgroundColor",         &Settings::backgroundColor),
+            field("stickToFloors",           &Settings::stickToFloors),
+            field("unscaledSize",            &Settings::unscaledSize, Optional | ReadOnly),
+            field("relativeTo",              &Settings::relativeTo, Required,
+                  EnumCodec{tryCstr2relativeToCamera, relativeToCamera2cstr}),
+            field("position",                &Settings::position, Required, PositionCodec{}),
+            field("rotation",                &Settings::rotation, Required, RealCodec{}),
+            field("zoom",                    &Settings::zoom, Required, RealCodec{}),
+        });
+        // clang-format on
 
-        if (jsonSettings.HasMember("unscaledSize"))
-            settings.unscaledSize = jsonSettings["unscaledSize"].GetDouble();
+        /**
+         * rapidjson copies the strings of a value by reference when they are constant, which those of an in-situ
+         * parse are, so a value that must outlive the json text is rebuilt through this handler instead.
+         * @brief A rapidjson SAX handler that forwards to a document and makes it copy every string.
+         */
+        class CopyStringsHandler
+        {
+        public:
+            explicit CopyStringsHandler(rapidjson::Document& document) : m_document(document) {}
 
-        settings.relativeTo = cstr2relativeToCamera(jsonSettings["relativeTo"].GetString());
-        settings.position = Vector2lf(jsonSettings["position"][0].GetDouble(), jsonSettings["position"][1].GetDouble());
-        settings.rotation = jsonSettings["rotation"].GetDouble();
-        settings.zoom = jsonSettings["zoom"].GetDouble();
+            // clang-format off
+            bool Null() { return m_document.Null(); }
+            bool Bool(const bool b) { return m_document.Bool(b); }
+            bool Int(const int i) { return m_document.Int(i); }
+            bool Uint(const unsigned u) { return m_document.Uint(u); }
+            bool Int64(const int64_t i) { return m_document.Int64(i); }
+            bool Uint64(const uint64_t u) { return m_document.Uint64(u); }
+            bool Double(const double d) { return m_document.Double(d); }
+            bool RawNumber(const char* str, const rapidjson::SizeType length, bool) { return m_document.RawNumber(str, length, true); }
+            bool String(const char* str, const rapidjson::SizeType length, bool) { return m_document.String(str, length, true); }
+            bool StartObject() { return m_document.StartObject(); }
+            bool Key(const char* str, const rapidjson::SizeType length, bool) { return m_document.Key(str, length, true); }
+            bool EndObject(const rapidjson::SizeType memberCount) { return m_document.EndObject(memberCount); }
+            bool StartArray() { return m_document.StartArray(); }
+            bool EndArray(const rapidjson::SizeType elementCount) { return m_document.EndArray(elementCount); }
+            // clang-format on
 
-        settings.stickToFloors = toBool(jsonSettings["stickToFloors"]);
+        private:
+            rapidjson::Document& m_document;
+        };
+    } // namespace
 
+    Settings::Settings(const rapidjson::Value& jsonSettings) { *this = fromJson(jsonSettings); }
+    Settings Settings::fromJson(const rapidjson::Value& jsonSettings)
+    {
+        Settings settings;
+        JsonReader reader(jsonSettings);
+        settings.read(reader);
+        if (!reader.ok())
+            throw std::invalid_argument(reader.error());
         return settings;
     }
+    void Settings::read(JsonReader& reader)
+    {
+        settingsFields.read(reader, *this);
+        // Older levels name it hitsoundSingle.
+        if (!reader.has("hitsoundVolume"))
+            reader.read("hitsoundSingle", hitsoundVolume);
+    }
     std::unique_ptr<rapidjson::GenericValue<rapidjson::UTF8<>>>
     Settings::intoJson(rapidjson::Document::AllocatorType& alloc) const
     {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
-        val->AddMember("version", 15, alloc);
-        rapidjson::Value vArtist;
-        vArtist.SetString(artist.c_str(), artist.length(), alloc);
-        val->AddMember("artist", vArtist, alloc);
-        rapidjson::Value vSong;
-        vSong.SetString(artist.c_str(), artist.length(), alloc);
-        val->AddMember("song", vSong, alloc);
-        rapidjson::Value vAuthor;
-        vAuthor.SetString(author.c_str(), author.length(), alloc);
-        val->AddMember("author", vAuthor, alloc);
-        val->AddMember("separateCountdownTime", separateCountdownTime, alloc);
-        val->AddMember("countdownTicks", countdownTicks, alloc);
-        rapidjson::Value vSongFilename;
-        vSongFilename.SetString(songFilename.c_str(), songFilename.length(), alloc);
-        val->AddMember("songFilename", vSongFilename, alloc);
-        val->AddMember("bpm", bpm, alloc);
-        val->AddMember("volume", volume, alloc);
-        val->AddMember("offset", offset, alloc);
-        val->AddMember("pitch", pitch, alloc);
-        val->AddMember("hitsound", rapidjson::StringRef(hitsound2cstr(hitsound)), alloc);
-        val->AddMember("hitsoundVolume", hitsoundVolume, alloc);
-        val->AddMember("trackColorType", rapidjson::StringRef(trackColorType2cstr(trackColorType)), alloc);
-        rapidjson::Value vTrackColor;
-        std::string sTrackColor = trackColor.toString(false, false, Color::ToStringAlphaMode::Auto);
-        vTrackColor.SetString(sTrackColor.c_str(), sTrackColor.length(), alloc);
-        val->AddMember("trackColor", vTrackColor, alloc);
-        rapidjson::Value vSSTC;
-        std::string sSSTC = trackColor.toString(false, false, Color::ToStringAlphaMode::Auto);
-        vSSTC.SetString(sSSTC.c_str(), sSSTC.length(), alloc);
-        val->AddMember("secondaryTrackColor", vSSTC, alloc);
-        val->AddMember("trackColorAnimDuration", trackColorAnimDuration, alloc);
-        val->AddMember("trackColorPulse", rapidjson::StringRef(trackColorPulse2cstr(trackColorPulse)), alloc);
-        val->AddMember("trackPulseLength", trackPulseLength, alloc);
-        val->AddMember("trackStyle", rapidjson::StringRef(trackStyle2cstr(trackStyle)), alloc);
-        val->AddMember("trackAnimation", rapidjson::StringRef(trackAnimation2cstr(trackAnimation)), alloc);
-        val->AddMember("beatsAhead", beatsAhead, alloc);
-        val->AddMember("trackDisappearAnimation",
-                      rapidjson::StringRef(trackDisappearAnimation2cstr(trackDisappearAnimation)), alloc);
-        val->AddMember("beatsBehind", beatsBehind, alloc);
-        rapidjson::Value vBGC;
-        std::string sBGC = backgroundColor.toString(false, false, Color::ToStringAlphaMode::Auto);
-        vBGC.SetString(sBGC.c_str(), sBGC.length(), alloc);
-        val->AddMember("backgroundColor", vBGC, alloc);
-        val->AddMember("stickToFloors", stickToFloors, alloc);
-        // val->AddMember("unscaledSize", unscaledSize, alloc);
-        val->AddMember("relativeTo", rapidjson::StringRef(relativeToCamera2cstr(relativeTo)), alloc);
-        rapidjson::Value vPos(rapidjson::kArrayType);
-        vPos.PushBack(position.x, alloc), vPos.PushBack(position.y, alloc);
-        val->AddMember("position", vPos, alloc);
-        val->AddMember("rotation", rotation, alloc);
-        val->AddMember("zoom", zoom, alloc);
-        return val;
+        JsonValueWriter writer(alloc);
+        write(writer);
+        return std::make_unique<rapidjson::Value>(writer.take());
     }
     std::unique_ptr<rapidjson::Document> Settings::intoJson() const
     {
@@ -132,6 +157,13 @@ namespace AdoCpp
         doc->CopyFrom(*intoJson(doc->GetAllocator()), doc->GetAllocator());
         return doc;
     }
+    void Settings::write(JsonWriter& writer) const
+    {
+        writer.startObject();
+        writer.member("version", 15);
+        settingsFields.write(writer, *this);
+        writer.endObject();
+    }
     void Settings::apply(Tile& tile) const
     {
         tile.editorPos = tile.pos.o = {0, 0}, tile.stickToFloors = stickToFloors, tile.trackAnimationFloor = 0,
@@ -153,6 +185,17 @@ namespace AdoCpp
         // clang-format on
     }
 
+    void LoadDiagnostics::print(std::ostream& os) const
+    {
+        for (const auto& [action, reason] : warnings)
+        {
+            if (action != noAction)
+                os << "Action " << action << ": ";
+            os << reason << '\n';
+        }
+        os.flush();
+    }
+
     Level::Level(const rapidjson::Document& document) { fromJson(document); }
 
     Level::Level(std::ifstream& ifs) { fromFile(ifs); }
@@ -164,11 +207,17 @@ namespace AdoCpp
     void Level::clear()
     {
         parsed = false;
+        m_hasDeferredEvents = false;
         settings = Settings();
         tiles.clear();
+        decorations.clear();
         m_processedDynamicEvents.clear();
         m_moveCameraDatas.clear();
         m_setSpeeds.clear();
+        m_tempoSegments.clear();
+        m_nextWindow = {};
+        m_farTracks.reset();
+        m_window = StreamingWindow();
     }
 
     void Level::defaultLevel()
@@ -182,93 +231,316 @@ namespace AdoCpp
         update();
     }
     void Level::fromJson(const rapidjson::Document& document)
+    {
+        LoadDiagnostics diagnostics;
+        fromJson(document, diagnostics);
+        if (!diagnostics.empty())
+            diagnostics.print(std::cout);
+    }
+    void Level::fromJson(const rapidjson::Document& document, LoadDiagnostics& diagnostics)
     {
         clear();
-        assert(document.IsObject());
+        if (!document.IsObject())
+            throw LevelFormatException("the level is not a json object");
 
         tiles.emplace_back(0);
-        if (document.HasMember("angleData"))
+        if (const auto angleData = document.FindMember("angleData");
+            angleData != document.MemberEnd() && angleData->value.IsArray())
+        {
+            for (const auto& angle : angleData->value.GetArray())
+            {
+                if (angle.IsNumber())
+                    tiles.emplace_back(angle.GetDouble());
+                else
+                    diagnostics.warn(LoadDiagnostics::noAction, "angleData has an element that is not a number");
+            }
+        }
+        else if (const auto pathData = document.FindMember("pathData");
+                 pathData != document.MemberEnd() && pathData->value.IsString())
         {
-            for (const auto& angle : document["angleData"].GetArray())
-                tiles.emplace_back(angle.GetDouble());
+            addPathTiles({pathData->value.GetString(), pathData->value.GetStringLength()}, diagnostics);
         }
         else
         {
-            assert(document.HasMember("pathData") && "The json must have either 'angleData' or 'pathData'");
-            for (const auto& path : std::string(document["pathData"].GetString()))
-                tiles.emplace_back(path2angle(path));
+            clear();
+            throw LevelFormatException("the level has neither angleData nor pathData");
         }
 
-        settings = Settings::fromJson(document["settings"]);
+        if (const auto jsonSettings = document.FindMember("settings"); jsonSettings != document.MemberEnd())
+            readSettings(jsonSettings->value, diagnostics);
+        else
+            diagnostics.warn(LoadDiagnostics::noAction, "the level has no settings");
 
-        for (const auto& eventData : document["actions"].GetArray())
+        if (const auto actions = document.FindMember("actions");
+            actions != document.MemberEnd() && actions->value.IsArray())
         {
-            try
+            const auto array = actions->value.GetArray();
+            auto events = newEvents(array.Begin(), array.Size(), 0, diagnostics);
+            for (size_t i = 0; i < events.size(); i++)
             {
-                if (auto event = std::shared_ptr<Event::Event>(Event::newEvent(eventData)))
-                    tiles[event->floor].events.push_back(event);
+                if (!events[i])
+                    continue;
+                if (events[i]->floor >= tiles.size())
+                    diagnostics.warn(i, floorOutOfRange(*events[i]));
+                else
+                    tiles[events[i]->floor].events.push_back(std::move(events[i]));
             }
-            catch (std::exception& e)
+        }
+
+        if (document.HasMember("decorations"))
+            decorations = compactJson(document["decorations"]);
+    }
+    std::vector<std::shared_ptr<Event::Event>> Level::newEvents(const rapidjson::Value* actions, const size_t count,
+                                                                const size_t firstIndex,
+                                                                LoadDiagnostics& diagnostics)
+    {
+        // Every chunk writes its own slots and warnings, so the result does not depend on the scheduling.
+        std::vector<std::shared_ptr<Event::Event>> events(count);
+        std::vector<std::vector<LoadDiagnostics::Warning>> warnings((count + parallelDecodeGrain - 1) /
+                                                                    parallelDecodeGrain);
+        std::vector<char> deferred(warnings.size());
+        const auto decode = [this, actions, firstIndex, &events, &warnings, &deferred](const size_t first,
+                                                                                       const size_t last)
+        {
+            // The deferred actions of a chunk are copied into an array of its own.
+            std::shared_ptr<rapidjson::Document> copies;
+            std::string error;
+            for (size_t i = first; i < last; i++)
             {
-                std::cout << e.what() << std::endl;
+                if (m_lazyDecoding)
+                {
+                    if (const auto event = deferEvent(actions[i], firstIndex + i, copies, last - first))
+                    {
+                        events[i] = event;
+                        deferred[i / parallelDecodeGrain] = true;
+                        continue;
+                    }
+                }
+                if (const auto event = Event::tryNewEvent(actions[i], error))
+                    events[i] = std::shared_ptr<Event::Event>(event);
+                else
+                    warnings[i / parallelDecodeGrain].push_back({firstIndex + i, std::move(error)});
             }
+        };
+        if (count >= m_parallelDecodeThreshold)
+            ThreadPool::global().parallelFor(0, count, parallelDecodeGrain, decode);
+        else
+            decode(0, count);
+
+        for (auto& chunkWarnings : warnings)
+            for (auto& warning : chunkWarnings)
+                diagnostics.warnings.push_back(std::move(warning));
+        if (std::ranges::find(deferred, true) != deferred.end())
+            m_hasDeferredEvents = true;
+        return events;
+    }
+    std::shared_ptr<Event::Deferred> Level::deferEvent(const rapidjson::Value& action, const size_t actionIndex,
+                                                       std::shared_ptr<rapidjson::Document>& copies,
+                                                       const size_t capacity)
+    {
+        if (!action.IsObject())
+            return nullptr;
+        const auto eventType = action.FindMember("eventType");
+        if (eventType == action.MemberEnd() || !eventType->value.IsString())
+            return nullptr;
+        const char* const name =
+            Event::deferrableEventType({eventType->value.GetString(), eventType->value.GetStringLength()});
+        if (!name)
+            return nullptr;
+        // An invalid header is left to tryNewEvent(), which reports it.
+        Event::Deferred header(name, nullptr, 0, actionIndex);
+        JsonReader reader(action);
+        header.read(reader);
+        if (!reader.ok())
+            return nullptr;
+
+        if (!copies)
+        {
+            copies = std::make_shared<rapidjson::Document>(rapidjson::kArrayType);
+            copies->Reserve(static_cast<rapidjson::SizeType>(capacity), copies->GetAllocator());
         }
+        // The action may point into the json text (see CopyStringsHandler), which is freed after loading.
+        rapidjson::Document copy(&copies->GetAllocator());
+        auto generator = [&action](rapidjson::Document& document)
+        {
+            CopyStringsHandler handler(document);
+            return action.Accept(handler);
+        };
+        copy.Populate(generator);
+        const auto index = copies->Size();
+        copies->PushBack(copy.Move(), copies->GetAllocator());
+        auto event = std::make_shared<Event::Deferred>(name, copies, index, actionIndex);
+        event->floor = header.floor, event->active = header.active;
+        return event;
+    }
+    void Level::readSettings(const rapidjson::Value& json, LoadDiagnostics& diagnostics)
+    {
+        JsonReader reader(json);
+        settings.read(reader);
+        if (!reader.ok())
+            diagnostics.warn(LoadDiagnostics::noAction, "settings: " + reader.error());
+    }
+    void Level::addPathTiles(const std::string_view pathData, LoadDiagnostics& diagnostics)
+    {
+        tiles.reserve(tiles.size() + pathData.size());
+        for (const char path : pathData)
+        {
+            // A lookup in pathAngles rather than tryPath2angle() keeps the loop free of optionals.
+            if (const double angle = pathAngles[static_cast<unsigned char>(path)]; angle == angle)
+                tiles.emplace_back(angle);
+            else
+                diagnostics.warn(LoadDiagnostics::noAction,
+                                 std::string("pathData has an invalid character '") + path + "'");
+        }
+    }
+    bool Level::encodePathData(std::string& out) const
+    {
+        out.resize(tiles.empty() ? 0 : tiles.size() - 1);
+        for (size_t i = 1; i < tiles.size(); i++)
+        {
+            const auto path = tryAngle2path(tiles[i].angle.deg());
+            if (!path)
+                return false;
+            out[i - 1] = *path;
+        }
+        return true;
+    }
+    std::string Level::floorOutOfRange(const Event::Event& event)
+    {
+        return std::string(event.name()) + ": floor " + std::to_string(event.floor) + " is out of range";
     }
 
     void Level::fromFile(std::ifstream& ifs)
+    {
+        LoadDiagnostics diagnostics;
+        fromFile(ifs, diagnostics);
+        if (!diagnostics.empty())
+            diagnostics.print(std::cout);
+    }
+    void Level::fromFile(std::ifstream& ifs, LoadDiagnostics& diagnostics)
     {
         rapidjson::Document document;
         rapidjson::IStreamWrapper isw(ifs);
         rapidjson::AutoUTFInputStream<unsigned, rapidjson::IStreamWrapper> eis(isw);
-        document.ParseStream<rapidjson::kParseValidateEncodingFlag | rapidjson::kParseCommentsFlag |
-                                 rapidjson::kParseTrailingCommasFlag | rapidjson::kParseNanAndInfFlag
-                             //| rapidjson::kParseFullPrecisionFlag
-                             ,
-                             rapidjson::AutoUTF<unsigned>>(eis);
-        if (document.HasParseError())
-            throw LevelJsonException(document.GetParseError());
-        fromJson(document);
+        if (const auto result = parseLevelJson<levelParseFlags, rapidjson::AutoUTF<unsigned>>(document, eis);
+            result.IsError())
+            throw LevelJsonException(result.Code());
+        fromJson(document, diagnostics);
     }
 
     void Level::fromFile(const std::filesystem::path& path)
     {
-        std::ifstream ifs(path);
-        if (!ifs.is_open())
-            throw LevelCouldNotOpenFileException();
-        fromFile(ifs);
-        ifs.close();
+        LoadDiagnostics diagnostics;
+        fromFile(path, diagnostics);
+        if (!diagnostics.empty())
+            diagnostics.print(std::cout);
     }
-    std::unique_ptr<rapidjson::Value> Level::intoJson(rapidjson::Document::AllocatorType& alloc) const
+    void Level::fromFile(const std::filesystem::path& path, LoadDiagnostics& diagnostics)
+    {
+        load(path, diagnostics, nullptr);
+    }
+    void Level::load(const std::filesystem::path& path, LoadDiagnostics& diagnostics, LoadProgress* progress)
     {
-        auto val = std::make_unique<rapidjson::Value>(rapidjson::kObjectType);
+        MappedFile file;
+        if (!file.open(path))
+            throw LevelCouldNotOpenFileException();
+        // The name must be computed before the in-situ parse changes the buffer.
+        std::filesystem::path cachePath;
+        if (!m_cacheDirectory.empty())
         {
-            rapidjson::Value angleData(rapidjson::kArrayType);
-            for (size_t i = 1; i < tiles.size(); i++)
+            cachePath = m_cacheDirectory / Binary::cacheFileName(file.data(), file.size());
+            if (loadCache(cachePath))
+                return;
+        }
+        const size_t warningCount = diagnostics.warnings.size();
+        // A level that loads with warnings, including those of its deferred events, is not cached.
+        const auto cache = [&]
+        {
+            if (cachePath.empty() || tiles.size() < 2)
+                return;
+            decodeEvents(diagnostics);
+            if (diagnostics.warnings.size() == warningCount)
+                storeCache(cachePath);
+        };
+        char* json = file.data();
+        const auto bytes = reinterpret_cast<const unsigned char*>(json);
+        if (file.size() >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
+        {
+            json += 3;
+        }
+        else if (file.size() >= 2 && (bytes[0] == 0xFE || bytes[0] == 0xFF || bytes[0] == 0 || bytes[1] == 0))
+        {
+            // UTF-16 or UTF-32: let AutoUTFInputStream detect and transcode it
+            file.close();
+            std::ifstream ifs(path, std::ios::binary);
+            if (!ifs.is_open())
+                throw LevelCouldNotOpenFileException();
+            fromFile(ifs, diagnostics);
+            cache();
+            return;
+        }
+
+        // No document is built: the reader turns each member into tiles and events as soon as it ends.
+        // Strings point into the mapping, which outlives the reader.
+        if (progress)
+            progress->enter(LoadStage::Json);
+        LevelReader levelReader(*this, diagnostics, progress, {json, file.size() - (json - file.data())});
+        rapidjson::Reader reader;
+        rapidjson::InsituStringStream iss(json);
+        try
+        {
+            if (const auto result = reader.Parse<levelParseFlags | rapidjson::kParseInsituFlag>(iss, levelReader);
+                result.IsError())
             {
-                if (const auto& tile = tiles[i]; static_cast<int>(tile.angle.deg()) == tile.angle.deg())
-                    angleData.PushBack(static_cast<int>(tile.angle.deg()), alloc);
-                else
-                    angleData.PushBack(tile.angle.deg(), alloc);
+                if (progress && progress->cancelled)
+                    throw LevelLoadCancelledException();
+                throw LevelJsonException(result.Code());
             }
-            val->AddMember("angleData", angleData, alloc);
+            levelReader.finish();
         }
+        catch (...)
         {
-            val->AddMember("settings", *settings.intoJson(alloc), alloc);
+            clear();
+            throw;
         }
+        cache();
+    }
+    LevelMetadata Level::peekMetadata(const std::filesystem::path& path)
+    {
+        MappedFile file;
+        if (!file.open(path))
+            throw LevelCouldNotOpenFileException();
+        std::string_view json(file.data(), file.size());
+        const auto bytes = reinterpret_cast<const unsigned char*>(json.data());
+        if (json.size() >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
         {
-            rapidjson::Value actions(rapidjson::kArrayType);
-            for (const auto& tile : tiles)
-                for (const auto& event : tile.events)
-                    actions.PushBack(*event->intoJson(alloc), alloc);
-
-            val->AddMember("actions", actions, alloc);
+            json.remove_prefix(3);
         }
+        else if (json.size() >= 2 && (bytes[0] == 0xFE || bytes[0] == 0xFF || bytes[0] == 0 || bytes[1] == 0))
         {
-            rapidjson::Value decorations(rapidjson::kArrayType);
-            val->AddMember("decorations", decorations, alloc);
+            // UTF-16 or UTF-32 is rare enough to be parsed as a whole document.
+            file.close();
+            std::ifstream ifs(path, std::ios::binary);
+            if (!ifs.is_open())
+                throw LevelCouldNotOpenFileException();
+            rapidjson::Document document;
+            rapidjson::IStreamWrapper isw(ifs);
+            rapidjson::AutoUTFInputStream<unsigned, rapidjson::IStreamWrapper> eis(isw);
+            if (const auto result = parseLevelJson<levelParseFlags, rapidjson::AutoUTF<unsigned>>(document, eis);
+                result.IsError())
+                throw LevelJsonException(result.Code());
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer writer(buffer);
+            document.Accept(writer);
+            return LevelSkimmer({buffer.GetString(), buffer.GetSize()}).skim();
         }
-
-        return val;
+        return LevelSkimmer(json).skim();
+    }
+    std::unique_ptr<rapidjson::Value> Level::intoJson(rapidjson::Document::AllocatorType& alloc) const
+    {
+        JsonValueWriter writer(alloc);
+        write(writer);
+        return std::make_unique<rapidjson::Value>(writer.take());
     }
     std::unique_ptr<rapidjson::Document> Level::intoJson() const
     {
@@ -277,12 +549,96 @@ namespace AdoCpp
         return doc;
     }
 
+    void Level::write(JsonWriter& writer) const
+    {
+        writer.startObject();
+        if (std::string pathData; m_writePathData && encodePathData(pathData))
+        {
+            writer.key("pathData");
+            writer.string(pathData);
+        }
+        else
+        {
+            writer.key("angleData");
+            writer.startArray();
+            for (size_t i = 1; i < tiles.size(); i++)
+                writer.number(tiles[i].angle.deg());
+            writer.endArray();
+        }
+        writer.key("settings");
+        settings.write(writer);
+        writer.key("actions");
+        writer.startArray();
+        writeActions(writer);
+        writer.endArray();
+        writer.key("decorations");
+        if (decorations.empty())
+        {
+            writer.startArray();
+            writer.endArray();
+        }
+        else
+            writer.raw(decorations);
+        writer.endObject();
+    }
+
+    void Level::writeActions(JsonWriter& writer) const
+    {
+        const auto writeTiles = [this](JsonWriter& w, const size_t first, const size_t last)
+        {
+            for (size_t i = first; i < last; i++)
+                for (const auto& event : tiles[i].events)
+                    event->write(w);
+        };
+        size_t count = 0;
+        for (const auto& tile : tiles)
+            count += tile.events.size();
+        if (count < m_parallelWriteThreshold || !writer.supportsChunks())
+        {
+            writeTiles(writer, 0, tiles.size());
+            return;
+        }
+
+        // Floor ranges of about parallelWriteGrain actions each.
+        std::vector<size_t> bounds{0};
+        for (size_t i = 0, actions = 0; i < tiles.size(); i++)
+        {
+            actions += tiles[i].events.size();
+            if (actions >= parallelWriteGrain)
+                bounds.push_back(i + 1), actions = 0;
+        }
+        if (bounds.back() != tiles.size())
+            bounds.push_back(tiles.size());
+
+        // The chunks are written a few per worker at a time, so the buffers do not hold the whole level.
+        ThreadPool& pool = ThreadPool::global();
+        const size_t chunkCount = bounds.size() - 1, wave = (pool.size() + 1) * 4;
+        std::vector<std::unique_ptr<JsonWriter>> chunks;
+        for (size_t first = 0; first < chunkCount; first += wave)
+        {
+            const size_t last = std::min(first + wave, chunkCount);
+            chunks.clear();
+            for (size_t i = first; i < last; i++)
+                chunks.push_back(writer.newArrayChunk());
+            pool.parallelFor(first, last, 1,
+                             [&](const size_t begin, const size_t end)
+                             {
+                                 for (size_t i = begin; i < end; i++)
+                                     writeTiles(*chunks[i - first], bounds[i], bounds[i + 1]);
+                             });
+            for (const auto& chunk : chunks)
+                writer.appendArrayChunk(*chunk);
+        }
+    }
+
     void Level::parse(const size_t floorStart, const bool basic, const bool force)
     {
         if (parsed && !force && !onlyBasic)
             return;
         assert(tiles.size() >= 2 && "AdoCpp::Level class must have at least two tiles to parse");
         parsed = true, onlyBasic = basic;
+        if (!basic && m_hasDeferredEvents)
+            decodeEvents();
         parseTiles(floorStart);
         parseSetSpeed();
         if (basic)
@@ -291,18 +647,57 @@ namespace AdoCpp
             parsed = true;
             return;
         }
-        std::vector<Event::DynamicEvent*> dynamicEvents;
-        std::vector<std::vector<Event::Modifiers::RepeatEvents*>> vecRe{tiles.size()};
-        parseDynamicEvents(dynamicEvents, vecRe);
         if (!m_disableAnimateTrack)
             parseAnimateTrack();
-        parseRepeatEvents(dynamicEvents, vecRe);
-        m_processedDynamicEvents.sort([](const auto& a, const auto& b) { return a->beat < b->beat; }); // stable sort
-        parseMoveTrackData();
+        resolveDynamicEvents();
+        if (m_streamingWindow > 0)
+            parseStreamingSource();
+        else
+            parseMoveTrackData();
 
         tiles[0].beat = tiles[0].seconds = -std::numeric_limits<double>::infinity();
         parsed = true;
     }
+    void Level::decodeEvents()
+    {
+        LoadDiagnostics diagnostics;
+        decodeEvents(diagnostics);
+        if (!diagnostics.empty())
+            diagnostics.print(std::cout);
+    }
+    void Level::decodeEvents(LoadDiagnostics& diagnostics)
+    {
+        m_hasDeferredEvents = false;
+        std::vector<std::shared_ptr<Event::Event>*> deferred;
+        for (auto& tile : tiles)
+            for (auto& event : tile.events)
+                if (typeid(*event) == typeid(Event::Deferred))
+                    deferred.push_back(&event);
+        if (deferred.empty())
+            return;
+
+        std::vector<std::string> errors(deferred.size());
+        std::vector<size_t> actions(deferred.size());
+        for (size_t i = 0; i < deferred.size(); i++)
+            actions[i] = static_cast<const Event::Deferred&>(**deferred[i]).action();
+        const auto decode = [&deferred, &errors](const size_t first, const size_t last)
+        {
+            for (size_t i = first; i < last; i++)
+                if (const auto event = static_cast<const Event::Deferred&>(**deferred[i]).decode(errors[i]))
+                    deferred[i]->reset(event);
+        };
+        if (deferred.size() >= m_parallelDecodeThreshold)
+            ThreadPool::global().parallelFor(0, deferred.size(), parallelDecodeGrain, decode);
+        else
+            decode(0, deferred.size());
+
+        // Whatever is still deferred is invalid.
+        for (size_t i = 0; i < deferred.size(); i++)
+            if (!errors[i].empty() && typeid(**deferred[i]) == typeid(Event::Deferred))
+                diagnostics.warn(actions[i], std::move(errors[i]));
+        for (auto& tile : tiles)
+            std::erase_if(tile.events, [](const auto& event) { return typeid(*event) == typeid(Event::Deferred); });
+    }
     void Level::update()
     {
         assert(parsed && "AdoCpp::Level class is not parsed");
@@ -320,20 +715,43 @@ namespace AdoCpp
     {
         assert(parsed && "AdoCpp::Level class is not parsed");
         update();
-        for (const auto& dynamicEvent : m_processedDynamicEvents)
+        size_t begin = 0, end = tiles.size();
+        if (m_streamingWindow > 0)
         {
-            if (seconds < dynamicEvent->seconds)
-                break;
-            if (auto recolorTrack = std::dynamic_pointer_cast<Event::Track::RecolorTrack>(dynamicEvent))
-                updateTileColorInfo(recolorTrack.get());
+            updateStreamingWindow(seconds);
+            begin = m_window.begin, end = m_window.end;
+            for (const auto& recolorTrack : m_window.recolorTracks)
+            {
+                if (seconds < recolorTrack->seconds)
+                    break;
+                updateTileColorInfo(recolorTrack.get(), begin, end - 1);
+            }
         }
-
-        for (size_t i = 0; i < tiles.size(); i++)
+        else
         {
-            updateTileColor(seconds, i);
-            updateTilePos(seconds, i);
+            for (const auto& dynamicEvent : m_processedDynamicEvents)
+            {
+                if (seconds < dynamicEvent->seconds)
+                    break;
+                if (auto recolorTrack = std::dynamic_pointer_cast<Event::Track::RecolorTrack>(dynamicEvent))
+                    updateTileColorInfo(recolorTrack.get());
+            }
         }
 
+        // Once the RecolorTrack state is resolved, each tile only depends on itself.
+        const auto updateTiles = [this, seconds](const size_t first, const size_t last)
+        {
+            for (size_t i = first; i < last; i++)
+            {
+                updateTileColor(seconds, i);
+                updateTilePos(seconds, i);
+            }
+        };
+        if (m_parallelUpdate && end - begin >= m_parallelUpdateThreshold)
+            ThreadPool::global().parallelFor(begin, end, parallelUpdateGrain, updateTiles);
+        else
+            updateTiles(begin, end);
+
         {
             // const double beat = seconds2beat(seconds);
             //
@@ -521,66 +939,118 @@ namespace AdoCpp
         }
         return bpm;
     }
+    template <typename Pred>
+    size_t Level::findTempoSegment(Pred applies) const
+    {
+        return std::partition_point(m_tempoSegments.begin() + 1, m_tempoSegments.end(), applies) -
+            m_tempoSegments.begin() - 1;
+    }
+    template <typename Pred>
+    size_t Level::findTempoSegment(Pred applies, size_t& hint) const
+    {
+        size_t i = std::min(hint, m_tempoSegments.size() - 1);
+        while (i + 1 < m_tempoSegments.size() && applies(m_tempoSegments[i + 1]))
+            i++;
+        while (i > 0 && !applies(m_tempoSegments[i]))
+            i--;
+        return hint = i;
+    }
     double Level::getBpmByBeat(const double beat) const
     {
-        return getBpm([&](const Event::GamePlay::SetSpeed& ss) { return beat >= ss.beat; });
+        assert(parsed && "AdoCpp::Level class is not parsed");
+        return m_tempoSegments[findTempoSegment([beat](const TempoSegment& seg) { return beat >= seg.beat; })].bpm;
     }
     double Level::getBpmBySeconds(const double seconds) const
     {
-        return getBpm([&](const Event::GamePlay::SetSpeed& ss) { return seconds >= ss.seconds; });
+        assert(parsed && "AdoCpp::Level class is not parsed");
+        return m_tempoSegments[findTempoSegment([seconds](const TempoSegment& seg) { return seconds >= seg.seconds; })]
+            .bpm;
     }
     double Level::getBpmExcludingBeat(const double beat) const
     {
-        return getBpm([&](const Event::GamePlay::SetSpeed& ss) { return beat > ss.beat; });
+        assert(parsed && "AdoCpp::Level class is not parsed");
+        return m_tempoSegments[findTempoSegment([beat](const TempoSegment& seg) { return beat > seg.beat; })].bpm;
     }
     double Level::getBpmForDynamicEvent(const size_t floor, const double angleOffset) const
     {
-        return getBpm([&](const Event::GamePlay::SetSpeed& ss)
-                      { return floor > ss.floor || (floor == ss.floor && angleOffset >= ss.angleOffset); });
+        assert(parsed && "AdoCpp::Level class is not parsed");
+        return m_tempoSegments[findTempoSegment(
+                                   [floor, angleOffset](const TempoSegment& seg) {
+                                       return floor > seg.floor || (floor == seg.floor && angleOffset >= seg.angleOffset);
+                                   })]
+            .bpm;
     }
     double Level::beat2seconds(const double beat) const
     {
         assert(parsed && "AdoCpp::Level class is not parsed");
-        double bpm = settings.bpm, b = 0, seconds = settings.offset / 1000;
-        for (const auto& setSpeed : m_setSpeeds)
-        {
-            seconds += bpm2crotchet(bpm) * (std::min(beat, setSpeed->beat) - b);
-            b = setSpeed->beat;
-            if (setSpeed->speedType == Event::GamePlay::SetSpeed::SpeedType::Bpm)
-                bpm = setSpeed->beatsPerMinute;
-            else
-                bpm *= setSpeed->bpmMultiplier;
-            if (beat <= setSpeed->beat)
-                return seconds;
-        }
-        seconds += bpm2crotchet(bpm) * (beat - b);
-        return seconds;
+        const auto& seg = m_tempoSegments[findTempoSegment([beat](const TempoSegment& s) { return beat > s.beat; })];
+        return seg.seconds + bpm2crotchet(seg.bpm) * (beat - seg.beat);
     }
 
-    double Level::seconds2beat(double seconds) const
+    double Level::seconds2beat(const double seconds) const
     {
         assert(parsed && "AdoCpp::Level class is not parsed");
-        seconds -= settings.offset / 1000;
-        double bpm = settings.bpm, last_beat = 0, beat = 0;
-        for (const auto& setSpeed : m_setSpeeds)
+        const auto& seg =
+            m_tempoSegments[findTempoSegment([seconds](const TempoSegment& s) { return seconds > s.seconds; })];
+        return seg.beat + (seconds - seg.seconds) / bpm2crotchet(seg.bpm);
+    }
+    double Level::seconds2beat(const double seconds, size_t& hint) const
+    {
+        const auto& seg =
+            m_tempoSegments[findTempoSegment([seconds](const TempoSegment& s) { return seconds > s.seconds; }, hint)];
+        return seg.beat + (seconds - seg.seconds) / bpm2crotchet(seg.bpm);
+    }
+    std::pair<double, double> Level::firstTileTime() const
+    {
+        const auto& first = m_tempoSegments.front();
+        const double beat = -settings.countdownTicks;
+        return {beat, first.seconds + bpm2crotchet(first.bpm) * (beat - first.beat)};
+    }
+    std::pair<double, double> Level::dynamicEventTime(const size_t floor, const double angleOffset, size_t& bpmHint,
+                                                      size_t& secondsHint) const
+    {
+        const auto [tileBeat, tileSeconds] =
+            floor == 0 ? firstTileTime() : std::pair(tiles[floor].beat, tiles[floor].seconds);
+        if (angleOffset == 0)
+            return {tileSeconds, tileBeat};
+        const double bpm = m_tempoSegments[findTempoSegment(
+                                               [floor, angleOffset](const TempoSegment& seg) {
+                                                   return floor > seg.floor ||
+                                                       (floor == seg.floor && angleOffset >= seg.angleOffset);
+                                               },
+                                               bpmHint)]
+                               .bpm;
+        const double seconds = tileSeconds + angleOffset / 180 * bpm2crotchet(bpm);
+        return {seconds, seconds2beat(seconds, secondsHint)};
+    }
+    template <typename F>
+    void Level::repeatEvent(const Event::Modifiers::RepeatEvents& repeatEvents, const size_t floor,
+                            const double angleOffset, const double seconds, const double beat, size_t& bpmHint,
+                            size_t& secondsHint, F repeat) const
+    {
+        const double startBeat = beat + angleOffset / 180;
+        const double spb = bpm2crotchet(
+            m_tempoSegments[findTempoSegment([startBeat](const TempoSegment& seg) { return startBeat >= seg.beat; },
+                                             bpmHint)]
+                .bpm);
+        if (repeatEvents.repeatType == Event::Modifiers::RepeatEvents::RepeatType::Beat)
         {
-            if (seconds > bpm2crotchet(bpm) * (setSpeed->beat - last_beat))
-                seconds -= bpm2crotchet(bpm) * (setSpeed->beat - last_beat);
-            else
+            const double gap = spb * repeatEvents.interval;
+            for (size_t i = 1; i <= repeatEvents.repetitions; i++)
             {
-                beat += seconds / bpm2crotchet(bpm);
-                return beat;
+                const double repeatSeconds = seconds + gap * static_cast<double>(i);
+                repeat(i, floor, repeatSeconds, seconds2beat(repeatSeconds, secondsHint));
+            }
+        }
+        else if (repeatEvents.repeatType == Event::Modifiers::RepeatEvents::RepeatType::Floor)
+        {
+            for (size_t i = 1; i <= repeatEvents.floorCount && floor + i < tiles.size(); i++)
+            {
+                const double repeatSeconds = tiles[floor + i].seconds + angleOffset / 180 * spb;
+                repeat(i, repeatEvents.executeOnCurrentFloor ? floor + i : floor, repeatSeconds,
+                       seconds2beat(repeatSeconds, secondsHint));
             }
-            beat += setSpeed->beat - last_beat;
-            if (setSpeed->speedType == Event::GamePlay::SetSpeed::SpeedType::Bpm)
-                bpm = setSpeed->beatsPerMinute;
-            else
-                bpm *= setSpeed->bpmMultiplier;
-            last_beat = setSpeed->beat;
         }
-        if (seconds != 0)
-            beat += seconds / bpm2crotchet(bpm);
-        return beat;
     }
 
     double Level::getAngle(const size_t floor) const
@@ -793,6 +1263,35 @@ namespace AdoCpp
             parsed = false;
         m_disableAnimateTrack = disable;
     }
+    bool Level::parallelUpdate() const { return m_parallelUpdate; }
+    void Level::parallelUpdate(const bool enable) { m_parallelUpdate = enable; }
+    size_t Level::parallelUpdateThreshold() const { return m_parallelUpdateThreshold; }
+    void Level::parallelUpdateThreshold(const size_t threshold) { m_parallelUpdateThreshold = threshold; }
+    size_t Level::parallelDecodeThreshold() const { return m_parallelDecodeThreshold; }
+    void Level::parallelDecodeThreshold(const size_t threshold) { m_parallelDecodeThreshold = threshold; }
+    size_t Level::parallelWriteThreshold() const { return m_parallelWriteThreshold; }
+    void Level::parallelWriteThreshold(const size_t threshold) { m_parallelWriteThreshold = threshold; }
+    bool Level::writePathData() const { return m_writePathData; }
+    void Level::writePathData(const bool enable) { m_writePathData = enable; }
+    bool Level::lazyDecoding() const { return m_lazyDecoding; }
+    void Level::lazyDecoding(const bool enable) { m_lazyDecoding = enable; }
+    const std::filesystem::path& Level::cacheDirectory() const { return m_cacheDirectory; }
+    void Level::cacheDirectory(const std::filesystem::path& directory) { m_cacheDirectory = directory; }
+    uintmax_t Level::cacheSizeLimit() const { return m_cacheSizeLimit; }
+    void Level::cacheSizeLimit(const uintmax_t bytes) { m_cacheSizeLimit = bytes; }
+    double Level::streamingWindow() const { return m_streamingWindow; }
+    void Level::streamingWindow(const double seconds)
+    {
+        if (m_streamingWindow != seconds)
+            parsed = false;
+        m_streamingWindow = seconds;
+    }
+    std::pair<size_t, size_t> Level::streamingRange() const
+    {
+        if (m_streamingWindow > 0)
+            return {m_window.begin, m_window.end};
+        return {0, tiles.size()};
+    }
 
     double Level::getTiming(const size_t floor, const double seconds) const
     {
@@ -853,14 +1352,15 @@ namespace AdoCpp
 
     void Level::parseTiles(const size_t beginFloor)
     {
+        // assign() keeps the capacity, so this only allocates when the level grows.
         // clang-format off
-        std::vector<bool>                                          twirls(tiles.size());
-        std::vector<double>                                        pauses(tiles.size());
-        std::vector<std::shared_ptr<Event::GamePlay::SetHitsound>> setHitsounds(tiles.size());
-        std::vector<std::shared_ptr<Event::Track::PositionTrack>>  positionTracks(tiles.size());
-        std::vector<std::shared_ptr<Event::Track::ColorTrack>>     colorTracks(tiles.size());
-        std::vector<std::shared_ptr<Event::Track::AnimateTrack>>   animateTracks(tiles.size());
-        std::vector<std::shared_ptr<Event::Dlc::Hold>>             holds(tiles.size());
+        auto& twirls         = m_scratch.twirls;         twirls        .assign(tiles.size(), false);
+        auto& pauses         = m_scratch.pauses;         pauses        .assign(tiles.size(), 0);
+        auto& setHitsounds   = m_scratch.setHitsounds;   setHitsounds  .assign(tiles.size(), nullptr);
+        auto& positionTracks = m_scratch.positionTracks; positionTracks.assign(tiles.size(), nullptr);
+        auto& colorTracks    = m_scratch.colorTracks;    colorTracks   .assign(tiles.size(), nullptr);
+        auto& animateTracks  = m_scratch.animateTracks;  animateTracks .assign(tiles.size(), nullptr);
+        auto& holds          = m_scratch.holds;          holds         .assign(tiles.size(), nullptr);
         for (size_t floor = beginFloor; floor < tiles.size(); floor++)
         {
             for (const auto& event : tiles[floor].events)
@@ -869,21 +1369,22 @@ namespace AdoCpp
                 if (!event->active)
                     continue;
 
-                if (typeid(*event.get()) == typeid(Event::GamePlay::Twirl))
-                    twirls[event->floor] = true;
-                else if (const auto pause                = std::dynamic_pointer_cast<Event::GamePlay::Pause>(event))
-                    pauses[pause->floor]                 = pause->duration;
-                else if (const auto setHitsound          = std::dynamic_pointer_cast<Event::GamePlay::SetHitsound>(event))
-                    setHitsounds[setHitsound->floor]     = setHitsound;
-
-                else if (const auto positionTrack        = std::dynamic_pointer_cast<Event::Track::PositionTrack>(event))
-                    positionTracks[positionTrack->floor] = positionTrack;
-                else if (const auto colorTrack           = std::dynamic_pointer_cast<Event::Track::ColorTrack>(event))
-                    colorTracks[colorTrack->floor]       = colorTrack;
-                else if (const auto animateTrack         = std::dynamic_pointer_cast<Event::Track::AnimateTrack>(event))
-                    animateTracks[animateTrack->floor]   = animateTrack;
-                else if (const auto hold                 = std::dynamic_pointer_cast<Event::Dlc::Hold>(event))
-                    holds[hold->floor]                   = hold;
+                const Event::Event* e = event.get();
+                if (typeid(*e) == typeid(Event::GamePlay::Twirl))
+                    twirls[floor] = true;
+                else if (const auto pause         = dynamic_cast<const Event::GamePlay::Pause*>(e))
+                    pauses[floor]                 = pause->duration;
+                else if (const auto setHitsound   = dynamic_cast<const Event::GamePlay::SetHitsound*>(e))
+                    setHitsounds[floor]           = setHitsound;
+
+                else if (const auto positionTrack = dynamic_cast<const Event::Track::PositionTrack*>(e))
+                    positionTracks[floor]         = positionTrack;
+                else if (const auto colorTrack    = dynamic_cast<const Event::Track::ColorTrack*>(e))
+                    colorTracks[floor]            = colorTrack;
+                else if (const auto animateTrack  = dynamic_cast<const Event::Track::AnimateTrack*>(e))
+                    animateTracks[floor]          = animateTrack;
+                else if (const auto hold          = dynamic_cast<const Event::Dlc::Hold*>(e))
+                    holds[floor]                  = hold;
             }
         }
         // clang-format on
@@ -1020,7 +1521,7 @@ namespace AdoCpp
         }
         tiles[0].beat = -settings.countdownTicks;
     }
-    void Level::parseSetSpeed()
+    void Level::collectSetSpeeds()
     {
         m_setSpeeds.clear();
         for (const auto& tile : tiles)
@@ -1033,8 +1534,51 @@ namespace AdoCpp
                         m_setSpeeds.push_back(setSpeed);
             }
         }
+        // SetSpeeds on the same floor take effect in the order of their angle offsets.
+        // They are already in floor order, so an insertion sort is linear and keeps equal ones in place.
+        for (size_t i = 1; i < m_setSpeeds.size(); i++)
+            for (size_t j = i; j > 0 && m_setSpeeds[j]->floor == m_setSpeeds[j - 1]->floor &&
+                 m_setSpeeds[j]->angleOffset < m_setSpeeds[j - 1]->angleOffset;
+                 j--)
+                std::swap(m_setSpeeds[j], m_setSpeeds[j - 1]);
+    }
+    void Level::parseSetSpeed()
+    {
+        collectSetSpeeds();
+        m_tempoSegments.clear();
+        m_tempoSegments.emplace_back(0, -std::numeric_limits<double>::infinity(), 0, settings.offset / 1000,
+                                     settings.bpm);
+        for (const auto& setSpeed : m_setSpeeds)
+        {
+            const TempoSegment& last = m_tempoSegments.back();
+            const double bpm = setSpeed->speedType == Event::GamePlay::SetSpeed::SpeedType::Bpm
+                ? setSpeed->beatsPerMinute
+                : last.bpm * setSpeed->bpmMultiplier;
+            setSpeed->seconds = last.seconds + bpm2crotchet(last.bpm) * (setSpeed->beat - last.beat);
+            m_tempoSegments.emplace_back(setSpeed->floor, setSpeed->angleOffset, setSpeed->beat, setSpeed->seconds,
+                                         bpm);
+        }
+
+        size_t hint = 0;
         for (auto& tile : tiles)
-            tile.seconds = beat2seconds(tile.beat);
+        {
+            const auto& seg = m_tempoSegments[findTempoSegment(
+                [&tile](const TempoSegment& s) { return tile.beat > s.beat; }, hint)];
+            tile.seconds = seg.seconds + bpm2crotchet(seg.bpm) * (tile.beat - seg.beat);
+        }
+    }
+    void Level::resolveDynamicEvents()
+    {
+        auto& dynamicEvents = m_scratch.dynamicEvents;
+        auto& vecRe = m_scratch.vecRe;
+        dynamicEvents.clear();
+        if (vecRe.size() < tiles.size())
+            vecRe.resize(tiles.size());
+        for (auto& re : vecRe)
+            re.clear();
+        parseDynamicEvents(dynamicEvents, vecRe);
+        parseRepeatEvents(dynamicEvents, vecRe);
+        m_processedDynamicEvents.sort([](const auto& a, const auto& b) { return a->beat < b->beat; }); // stable sort
     }
     void Level::parseDynamicEvents(std::vector<Event::DynamicEvent*>& dynamicEvents,
                                    std::vector<std::vector<Event::Modifiers::RepeatEvents*>>& vecRe)
@@ -1049,22 +1593,14 @@ namespace AdoCpp
                     continue;
                 if (auto dynamicEventPtr = std::dynamic_pointer_cast<Event::DynamicEvent>(event))
                 {
-                    if (typeid(dynamicEventPtr) == typeid(Event::GamePlay::SetSpeed))
+                    // SetSpeeds are already resolved by parseSetSpeed
+                    if (typeid(*dynamicEventPtr) == typeid(Event::GamePlay::SetSpeed))
+                        continue;
+                    // In streaming mode the MoveTracks and RecolorTracks are resolved window by window.
+                    if (m_streamingWindow > 0 &&
+                        (typeid(*dynamicEventPtr) == typeid(Event::Track::MoveTrack) ||
+                         typeid(*dynamicEventPtr) == typeid(Event::Track::RecolorTrack)))
                         continue;
-                    if (dynamicEventPtr->angleOffset == 0)
-                    {
-                        dynamicEventPtr->seconds = tiles[dynamicEventPtr->floor].seconds;
-                        dynamicEventPtr->beat = tiles[dynamicEventPtr->floor].beat;
-                    }
-                    else
-                    {
-                        const double bpm = getBpmForDynamicEvent(dynamicEventPtr->floor, dynamicEventPtr->angleOffset),
-                                     spb = bpm2crotchet(bpm);
-                        dynamicEventPtr->seconds =
-                            tiles[dynamicEventPtr->floor].seconds + dynamicEventPtr->angleOffset / 180 * spb;
-                        dynamicEventPtr->beat = seconds2beat(dynamicEventPtr->seconds);
-                    }
-
                     dynamicEvents.push_back(dynamicEventPtr.get());
                     m_processedDynamicEvents.push_back(dynamicEventPtr);
                 }
@@ -1074,103 +1610,48 @@ namespace AdoCpp
                 }
             }
         }
+
+        // Resolve the times in (floor, angleOffset) order, walking along the tempo segments.
+        auto& sweep = m_scratch.sweep;
+        sweep.assign(dynamicEvents.begin(), dynamicEvents.end());
+        std::ranges::sort(sweep, [](const Event::DynamicEvent* a, const Event::DynamicEvent* b)
+                          { return a->floor < b->floor || (a->floor == b->floor && a->angleOffset < b->angleOffset); });
+        size_t bpmHint = 0, secondsHint = 0;
+        for (const auto dynamicEvent : sweep)
+            std::tie(dynamicEvent->seconds, dynamicEvent->beat) =
+                dynamicEventTime(dynamicEvent->floor, dynamicEvent->angleOffset, bpmHint, secondsHint);
     }
     void Level::parseAnimateTrack()
     {
-        // AnimateTrack // FIXME
+        // The animations themselves are evaluated by updateTilePos, only their timing is resolved here.
+        size_t aheadHint = 0, durationHint = 0;
         for (size_t i = 0; i < tiles.size(); i++)
         {
-            const double spb = bpm2crotchet(getBpmByBeat(tiles[tiles[i].trackAnimationFloor].beat)),
-                         secondsAhead = tiles[i].beatsAhead * spb, secondsBehind = tiles[i].beatsBehind * spb;
-            if (i != 0)
-            {
-                // TODO complete the track animation & disappear animation
-                switch (tiles[i].trackAnimation)
-                {
-                case TrackAnimation::None:
-                    break;
-                case TrackAnimation::Fade:
-                default:
-                    {
-                        const auto mtHide = std::make_shared<Event::Track::MoveTrack>(),
-                                   mtAppear = std::make_shared<Event::Track::MoveTrack>();
-                        mtHide->floor = mtAppear->floor = i;
-                        mtHide->startTile = mtHide->endTile = mtAppear->startTile = mtAppear->endTile =
-                            RelativeIndex(0, ThisTile);
-                        mtHide->beat = mtHide->seconds = -std::numeric_limits<double>::infinity();
-                        mtHide->opacity = 0;
-                        mtAppear->seconds = tiles[i].seconds - secondsAhead;
-                        mtAppear->beat = seconds2beat(mtAppear->seconds);
-                        mtAppear->duration = 0.5;
-                        mtAppear->opacity = 100;
-                        mtHide->generated = mtAppear->generated = true;
-                        m_processedDynamicEvents.push_front(mtHide);
-                        m_processedDynamicEvents.push_front(mtAppear);
-                        break;
-                    }
-                case TrackAnimation::Grow_Spin:
-                    {
-                        const auto mtHide = std::make_shared<Event::Track::MoveTrack>(),
-                                   mtAppear = std::make_shared<Event::Track::MoveTrack>();
-                        mtHide->floor = mtAppear->floor = i;
-                        mtHide->startTile = mtHide->endTile = mtAppear->startTile = mtAppear->endTile =
-                            RelativeIndex(0, ThisTile);
-                        mtHide->beat = mtHide->seconds = -std::numeric_limits<double>::infinity();
-                        mtHide->rotationOffset = -180;
-                        mtHide->scale = OptionalPoint(std::make_optional(0.0), std::make_optional(0.0));
-                        mtAppear->seconds = tiles[i].seconds - secondsAhead;
-                        mtAppear->beat = seconds2beat(mtAppear->seconds);
-                        mtAppear->duration = 0.5;
-                        mtAppear->rotationOffset = 0;
-                        mtAppear->scale = OptionalPoint(std::make_optional(100.0), std::make_optional(100.0));
-                        mtHide->generated = mtAppear->generated = true;
-                        m_processedDynamicEvents.push_front(mtHide);
-                        m_processedDynamicEvents.push_front(mtAppear);
-                        break;
-                    }
-                }
-            }
-            if (i != tiles.size() - 1)
-            {
-                switch (tiles[i].trackDisappearAnimation)
-                {
-                case TrackDisappearAnimation::None:
-                    break;
-                case TrackDisappearAnimation::Fade:
-                default:
-                    {
-                        const auto mtDisappear = std::make_shared<Event::Track::MoveTrack>();
-                        mtDisappear->floor = i;
-                        mtDisappear->startTile = mtDisappear->endTile = RelativeIndex(0, ThisTile);
-                        mtDisappear->seconds = tiles[i + 1].seconds + secondsBehind;
-                        mtDisappear->beat = seconds2beat(mtDisappear->seconds);
-                        mtDisappear->duration = 0.5;
-                        mtDisappear->opacity = 0;
-                        mtDisappear->generated = true;
-                        m_processedDynamicEvents.insert(m_processedDynamicEvents.begin(), mtDisappear);
-                        break;
-                    }
-                case TrackDisappearAnimation::Shrink_Spin:
-                    {
-                        const auto mtDisappear = std::make_shared<Event::Track::MoveTrack>();
-                        mtDisappear->floor = i;
-                        mtDisappear->startTile = mtDisappear->endTile = RelativeIndex(0, ThisTile);
-                        mtDisappear->seconds = tiles[i + 1].seconds + secondsBehind;
-                        mtDisappear->beat = seconds2beat(mtDisappear->seconds);
-                        mtDisappear->duration = 0.5;
-                        mtDisappear->rotationOffset = 180;
-                        mtDisappear->scale = OptionalPoint(std::make_optional(0.0), std::make_optional(0.0));
-                        mtDisappear->generated = true;
-                        m_processedDynamicEvents.insert(m_processedDynamicEvents.begin(), mtDisappear);
-                        break;
-                    }
-                }
-            }
+            auto& tile = tiles[i];
+            const double animationBeat = tiles[tile.trackAnimationFloor].beat;
+            const double spb = bpm2crotchet(m_tempoSegments[findTempoSegment([animationBeat](const TempoSegment& seg)
+                                                                             { return animationBeat >= seg.beat; },
+                                                                             aheadHint)]
+                                                .bpm),
+                         tileSpb = bpm2crotchet(
+                             m_tempoSegments[findTempoSegment(
+                                                 // The tempo at the start of the tile, not one starting partway
+                                                 // through it.
+                                                 [i](const TempoSegment& seg)
+                                                 { return i > seg.floor || (i == seg.floor && seg.angleOffset <= 0); },
+                                                 durationHint)]
+                                 .bpm);
+            tile.appearSeconds = tile.seconds - tile.beatsAhead * spb;
+            tile.disappearSeconds = i + 1 < tiles.size() ? tiles[i + 1].seconds + tile.beatsBehind * spb
+                                                         : std::numeric_limits<double>::infinity();
+            tile.animationDuration = 0.5 * tileSpb;
         }
     }
     void Level::parseRepeatEvents(const std::vector<Event::DynamicEvent*>& dynamicEvents,
                                   const std::vector<std::vector<Event::Modifiers::RepeatEvents*>>& vecRe)
     {
+        // dynamicEvents is in floor order, so the hints mostly move forward.
+        size_t bpmHint = 0, secondsHint = 0;
         for (const auto& event : dynamicEvents)
             for (const auto& repeatEvents : vecRe[event->floor])
                 for (const auto& tag : repeatEvents->tag)
@@ -1178,37 +1659,55 @@ namespace AdoCpp
                     {
                         if (tag != eventTag)
                             continue;
-                        const double spb = bpm2crotchet(getBpmByBeat(event->beat + event->angleOffset / 180));
-                        if (repeatEvents->repeatType == Event::Modifiers::RepeatEvents::RepeatType::Beat)
-                        {
-                            const double gap = spb * repeatEvents->interval;
-                            for (size_t i = 1; i <= repeatEvents->repetitions; i++)
-                            {
-                                const auto eventClone = event->clone();
-                                eventClone->seconds += gap * static_cast<double>(i);
-                                eventClone->beat = seconds2beat(eventClone->seconds);
-                                eventClone->generated = true;
-                                m_processedDynamicEvents.push_front(std::shared_ptr<Event::DynamicEvent>(eventClone));
-                            }
-                        }
-                        else if (repeatEvents->repeatType == Event::Modifiers::RepeatEvents::RepeatType::Floor)
-                        {
-                            for (size_t i = 1; i <= repeatEvents->floorCount; i++)
-                            {
-                                const auto eventClone = event->clone();
-                                eventClone->seconds =
-                                    tiles[eventClone->floor + i].seconds + eventClone->angleOffset / 180 * spb;
-                                eventClone->beat = seconds2beat(eventClone->seconds);
-                                if (repeatEvents->executeOnCurrentFloor)
-                                    eventClone->floor += i;
-                                eventClone->generated = true;
-                                m_processedDynamicEvents.push_front(std::shared_ptr<Event::DynamicEvent>(eventClone));
-                            }
-                        }
+                        repeatEvent(*repeatEvents, event->floor, event->angleOffset, event->seconds, event->beat,
+                                    bpmHint, secondsHint,
+                                    [this, event](size_t, const size_t floor, const double seconds, const double beat)
+                                    {
+                                        const auto eventClone = event->clone();
+                                        eventClone->floor = floor;
+                                        eventClone->seconds = seconds;
+                                        eventClone->beat = beat;
+                                        eventClone->generated = true;
+                                        m_processedDynamicEvents.push_front(
+                                            std::shared_ptr<Event::DynamicEvent>(eventClone));
+                                    });
                     }
     }
+    /**
+     * @brief Set when each property of the MoveTracks stops being interpolated (when the next one touching it starts).
+     */
+    static void resolveMoveTrackEndSeconds(std::vector<Tile::MoveTrackData>& moveTrackDatas)
+    {
+        double xEndSec, yEndSec, rotEndSec, scXEndSec, scYEndSec,
+            opEndSec = xEndSec = yEndSec = rotEndSec = scXEndSec = scYEndSec =
+                std::numeric_limits<double>::infinity();
+        for (auto& moveTrackData : std::ranges::reverse_view(moveTrackDatas))
+        {
+            moveTrackData.xEndSec = xEndSec;
+            moveTrackData.yEndSec = yEndSec;
+            moveTrackData.rotEndSec = rotEndSec;
+            moveTrackData.scXEndSec = scXEndSec;
+            moveTrackData.scYEndSec = scYEndSec;
+            moveTrackData.opEndSec = opEndSec;
+            if (moveTrackData.positionOffset.first)
+                xEndSec = moveTrackData.seconds;
+            if (moveTrackData.positionOffset.second)
+                yEndSec = moveTrackData.seconds;
+            if (moveTrackData.rotationOffset)
+                rotEndSec = moveTrackData.seconds;
+            if (moveTrackData.scale.first)
+                scXEndSec = moveTrackData.seconds;
+            if (moveTrackData.scale.second)
+                scYEndSec = moveTrackData.seconds;
+            if (moveTrackData.opacity)
+                opEndSec = moveTrackData.seconds;
+        }
+    }
+
     void Level::parseMoveTrackData()
     {
+        for (auto& tile : tiles)
+            tile.moveTrackDatas.clear();
         for (const auto& event : m_processedDynamicEvents)
         {
             const auto mt = std::dynamic_pointer_cast<Event::Track::MoveTrack>(event);
@@ -1231,34 +1730,223 @@ namespace AdoCpp
             }
         }
         for (auto& tile : tiles)
+            resolveMoveTrackEndSeconds(tile.moveTrackDatas);
+    }
+    /**
+     * @brief Get the tiles a MoveTrack or RecolorTrack applies to (std::nullopt for other events).
+     */
+    static std::optional<std::pair<RelativeIndex, RelativeIndex>> trackTiles(const Event::Event& event)
+    {
+        if (const auto mt = dynamic_cast<const Event::Track::MoveTrack*>(&event))
+            return std::pair(mt->startTile, mt->endTile);
+        if (const auto rt = dynamic_cast<const Event::Track::RecolorTrack*>(&event))
+            return std::pair(rt->startTile, rt->endTile);
+        return std::nullopt;
+    }
+    bool Level::TrackOrder::operator<(const TrackOrder& other) const
+    {
+        if (beat != other.beat)
+            return beat < other.beat;
+        if (repetition != other.repetition)
+            return repetition;
+        return repetition ? other.creation < creation : creation < other.creation;
+    }
+    void Level::parseStreamingSource()
+    {
+        for (auto& tile : tiles)
+            tile.moveTrackDatas = {};
+        m_nextWindow = {};
+        m_window = StreamingWindow();
+
+        // Only the far tracks are resolved here; the others are resolved by the windows that need them.
+        const auto far = std::make_shared<StreamingSource>();
+        size_t bpmHint = 0, secondsHint = 0, repeatHint = 0;
+        for (size_t floor = 0; floor < tiles.size(); floor++)
+            collectStreamingTracks(floor, true, bpmHint, secondsHint, repeatHint,
+                                   std::numeric_limits<double>::infinity(), 0, tiles.size(), *far);
+        m_farTracks = far;
+    }
+    void Level::collectStreamingTracks(const size_t floor, const bool far, size_t& bpmHint, size_t& secondsHint,
+                                       size_t& repeatHint, const double lastSeconds, const size_t begin,
+                                       const size_t end, StreamingSource& source) const
+    {
+        const auto& events = tiles[floor].events;
+        std::vector<size_t> repeats;
+        for (size_t i = 0; i < events.size(); i++)
+            if (events[i]->active && typeid(*events[i]) == typeid(Event::Modifiers::RepeatEvents))
+                repeats.push_back(i);
+        const auto repeatEvents = [&events](const size_t i)
+        { return static_cast<const Event::Modifiers::RepeatEvents&>(*events[i]); };
+
+        for (size_t index = 0; index < events.size(); index++)
         {
-            double xEndSec, yEndSec, rotEndSec, scXEndSec, scYEndSec,
-                opEndSec = xEndSec = yEndSec = rotEndSec = scXEndSec = scYEndSec =
-                    std::numeric_limits<double>::infinity();
-            for (auto& moveTrackData : std::ranges::reverse_view(tile.moveTrackDatas))
+            const auto& event = *events[index];
+            const auto trackTileRange = trackTiles(event);
+            if (!event.active || !trackTileRange)
+                continue;
+            const auto& track = static_cast<const Event::DynamicEvent&>(event);
+            const auto [startTile, endTile] = *trackTileRange;
+
+            // A track is far if the floor scan of a window may miss it or one of its repetitions: it may start
+            // before its floor or reach more than streamingTrackReach tiles past it.
+            bool isFar = track.angleOffset < 0;
+            size_t lastTile = rel2absIndex(floor, endTile);
+            for (const size_t r : repeats)
+            {
+                const auto& re = repeatEvents(r);
+                if (!std::ranges::any_of(re.tag, [&track](const std::string& tag)
+                                         { return std::ranges::find(track.eventTag, tag) != track.eventTag.end(); }))
+                    continue;
+                if (re.repeatType == Event::Modifiers::RepeatEvents::RepeatType::Beat)
+                    isFar |= re.interval < 0;
+                else if (re.executeOnCurrentFloor)
+                    lastTile = std::max(lastTile,
+                                        rel2absIndex(std::min(floor + re.floorCount, tiles.size() - 1), endTile));
+            }
+            isFar |= lastTile > floor + streamingTrackReach;
+            if (isFar != far)
+                continue;
+
+            const auto add = [&](const size_t trackFloor, const double seconds, const double beat,
+                                 const TrackOrder& order)
+            {
+                const size_t b = rel2absIndex(trackFloor, startTile),
+                             e = std::min(tiles.size() - 1, rel2absIndex(trackFloor, endTile));
+                if (seconds > lastSeconds || b > e || b >= end || e < begin)
+                    return;
+                if (const auto mt = dynamic_cast<const Event::Track::MoveTrack*>(&track))
+                {
+                    // clang-format off
+                    source.moveTracks.emplace_back(b, e, order, Tile::MoveTrackData{
+                        trackFloor, mt->angleOffset, beat, seconds, mt->startTile, mt->endTile,
+                        mt->duration,
+                        mt->positionOffset, 114514, 114514,
+                        mt->rotationOffset, 114514,
+                        mt->scale, 114514, 114514,
+                        mt->opacity, 114514,
+                        mt->ease});
+                    // clang-format on
+                }
+                else
+                {
+                    const auto rt = static_cast<const Event::Track::RecolorTrack&>(track).clone();
+                    rt->floor = trackFloor, rt->seconds = seconds, rt->beat = beat, rt->generated = order.repetition;
+                    source.recolorTracks.emplace_back(b, e, order,
+                                                      std::shared_ptr<const Event::Track::RecolorTrack>(rt));
+                }
+            };
+            const auto [seconds, beat] = dynamicEventTime(floor, track.angleOffset, bpmHint, secondsHint);
+            add(floor, seconds, beat, {beat, false, {floor, index}});
+            for (const size_t r : repeats)
             {
-                moveTrackData.xEndSec = xEndSec;
-                moveTrackData.yEndSec = yEndSec;
-                moveTrackData.rotEndSec = rotEndSec;
-                moveTrackData.scXEndSec = scXEndSec;
-                moveTrackData.scYEndSec = scYEndSec;
-                moveTrackData.opEndSec = opEndSec;
-                if (moveTrackData.positionOffset.first)
-                    xEndSec = moveTrackData.seconds;
-                if (moveTrackData.positionOffset.second)
-                    yEndSec = moveTrackData.seconds;
-                if (moveTrackData.rotationOffset)
-                    rotEndSec = moveTrackData.seconds;
-                if (moveTrackData.scale.first)
-                    scXEndSec = moveTrackData.seconds;
-                if (moveTrackData.scale.second)
-                    scYEndSec = moveTrackData.seconds;
-                if (moveTrackData.opacity)
-                    opEndSec = moveTrackData.seconds;
+                const auto& re = repeatEvents(r);
+                for (size_t tag = 0; tag < re.tag.size(); tag++)
+                    for (size_t eventTag = 0; eventTag < track.eventTag.size(); eventTag++)
+                        if (re.tag[tag] == track.eventTag[eventTag])
+                            repeatEvent(re, floor, track.angleOffset, seconds, beat, repeatHint, secondsHint,
+                                        [&](const size_t i, const size_t repeatFloor, const double repeatSeconds,
+                                            const double repeatBeat)
+                                        {
+                                            add(repeatFloor, repeatSeconds, repeatBeat,
+                                                {repeatBeat, true, {floor, index, r, tag, eventTag, i}});
+                                        });
             }
         }
     }
-    void Level::updateTileColorInfo(const Event::Track::RecolorTrack* const recolorTrack)
+    std::shared_ptr<const Level::StreamingSource> Level::streamingSource(const double anchor, const size_t begin,
+                                                                        const size_t end) const
+    {
+        // Events after the window's last valid moment are never reached by update(), and cutting them off
+        // does not change the end times either since the playhead never passes them.
+        const double lastSeconds = anchor + 2 * m_streamingWindow;
+        auto source = std::make_shared<StreamingSource>();
+        for (const auto& track : m_farTracks->moveTracks)
+            if (track.data.seconds <= lastSeconds && track.begin < end && track.end >= begin)
+                source->moveTracks.push_back(track);
+        for (const auto& track : m_farTracks->recolorTracks)
+            if (track.event->seconds <= lastSeconds && track.begin < end && track.end >= begin)
+                source->recolorTracks.push_back(track);
+
+        // The other tracks start on their floor or later and reach at most streamingTrackReach tiles past it.
+        size_t bpmHint = 0, secondsHint = 0, repeatHint = 0;
+        const size_t last = std::min(tiles.size() - 1, getFloorBySeconds(lastSeconds));
+        for (size_t floor = begin > streamingTrackReach ? begin - streamingTrackReach : 0; floor <= last; floor++)
+            collectStreamingTracks(floor, false, bpmHint, secondsHint, repeatHint, lastSeconds, begin, end, *source);
+
+        const auto byOrder = [](const auto& a, const auto& b) { return a.order < b.order; };
+        std::ranges::sort(source->moveTracks, byOrder);
+        std::ranges::sort(source->recolorTracks, byOrder);
+        return source;
+    }
+    Level::StreamingWindow Level::buildStreamingWindow(const std::shared_ptr<const StreamingSource>& source,
+                                                       const double anchor, const double window, const size_t begin,
+                                                       const size_t end)
+    {
+        StreamingWindow result;
+        result.anchor = anchor, result.begin = begin, result.end = end;
+        result.moveTrackDatas.resize(end - begin);
+        for (const auto& [b, e, order, data] : source->moveTracks)
+            for (size_t i = std::max(b, begin); i <= e && i < end; i++)
+                result.moveTrackDatas[i - begin].push_back(data);
+        for (auto& moveTrackDatas : result.moveTrackDatas)
+            resolveMoveTrackEndSeconds(moveTrackDatas);
+        for (const auto& [b, e, order, event] : source->recolorTracks)
+            result.recolorTracks.push_back(event);
+        return result;
+    }
+    std::pair<size_t, size_t> Level::streamingFloors(const double anchor) const
+    {
+        // Every tile that may be on screen while the playhead is in [anchor, anchor + 2 * window].
+        return {getFloorBySeconds(anchor - m_streamingWindow),
+                std::min(tiles.size(), getFloorBySeconds(anchor + 3 * m_streamingWindow) + 2)};
+    }
+    bool Level::streamingCovers(const StreamingWindow& window, const double seconds) const
+    {
+        return seconds >= window.anchor && seconds <= window.anchor + 2 * m_streamingWindow;
+    }
+    void Level::updateStreamingWindow(const double seconds)
+    {
+        if (!streamingCovers(m_window, seconds))
+        {
+            StreamingWindow window;
+            if (m_nextWindow.valid())
+            {
+                if (seconds >= m_nextWindowAnchor && seconds <= m_nextWindowAnchor + 2 * m_streamingWindow)
+                    window = m_nextWindow.get();
+                else
+                    m_nextWindow = {}; // seeked away
+            }
+            if (!streamingCovers(window, seconds))
+            {
+                const auto [begin, end] = streamingFloors(seconds);
+                window = buildStreamingWindow(streamingSource(seconds, begin, end), seconds, m_streamingWindow, begin,
+                                              end);
+            }
+            applyStreamingWindow(std::move(window));
+        }
+        // Halfway through the window, start building the next one.
+        if (!m_nextWindow.valid() && seconds >= m_window.anchor + m_streamingWindow && m_window.end < tiles.size())
+        {
+            m_nextWindowAnchor = m_window.anchor + 2 * m_streamingWindow;
+            const auto [begin, end] = streamingFloors(m_nextWindowAnchor);
+            // The tracks are resolved here, so the background build never reads the events.
+            m_nextWindow = std::async(std::launch::async, &Level::buildStreamingWindow,
+                                      streamingSource(m_nextWindowAnchor, begin, end), m_nextWindowAnchor,
+                                      m_streamingWindow, begin, end);
+        }
+    }
+    void Level::applyStreamingWindow(StreamingWindow&& window)
+    {
+        for (size_t i = m_window.begin; i < m_window.end; i++)
+            if (i < window.begin || i >= window.end)
+                tiles[i].moveTrackDatas = {};
+        for (size_t i = window.begin; i < window.end; i++)
+            tiles[i].moveTrackDatas = std::move(window.moveTrackDatas[i - window.begin]);
+        window.moveTrackDatas.clear();
+        m_window = std::move(window);
+    }
+    void Level::updateTileColorInfo(const Event::Track::RecolorTrack* const recolorTrack, const size_t first,
+                                    const size_t last)
     {
         // double x, y;
         // if (!recolorTrack->duration || recolorTrack->duration == 0)
@@ -1267,8 +1955,8 @@ namespace AdoCpp
         //     x = (seconds - recolorTrack->seconds) /
         //         (*recolorTrack->duration * bpm2crotchet(getBpmByBeat(recolorTrack->beat))),
         //     y = ease(recolorTrack->ease, x);
-        const size_t b = rel2absIndex(recolorTrack->floor, recolorTrack->startTile),
-                     e = std::min(tiles.size() - 1, rel2absIndex(recolorTrack->floor, recolorTrack->endTile));
+        const size_t b = std::max(first, rel2absIndex(recolorTrack->floor, recolorTrack->startTile)),
+                     e = std::min({last, tiles.size() - 1, rel2absIndex(recolorTrack->floor, recolorTrack->endTile)});
         for (size_t i = b; i <= e; i++)
         {
             tiles[i].trackColor.c = recolorTrack->trackColor;
@@ -1342,6 +2030,20 @@ namespace AdoCpp
             tile.color = tile.trackColor.c;
         }
     }
+    /**
+     * @brief A pseudo-random but stable offset of length [distance / 2, distance) for the scatter animations.
+     */
+    static Vector2lf scatterOffset(const size_t floor, const uint64_t salt, const double distance)
+    {
+        uint64_t h = (floor + 1) * 0x9e3779b97f4a7c15ull ^ salt;
+        h = (h ^ h >> 30) * 0xbf58476d1ce4e5b9ull;
+        h = (h ^ h >> 27) * 0x94d049bb133111ebull;
+        h ^= h >> 31;
+        const double angle = static_cast<double>(h & 0xffff) / 0x10000 * 2 * 3.141592653589793,
+                     length = distance * (0.5 + static_cast<double>(h >> 16 & 0xffff) / 0x20000);
+        return {cos(angle) * length, sin(angle) * length};
+    }
+
     void Level::updateTilePos(const double seconds, const size_t i)
     {
         for (auto& tile = tiles[i]; const auto& data : tile.moveTrackDatas) // FIXME
@@ -1382,5 +2084,73 @@ namespace AdoCpp
                 tile.opacity += (*data.opacity - tile.opacity) * y;
             }
         }
+
+        // Track animations are applied on top of the MoveTracks: positions and rotations are offset,
+        // scales and opacities are multiplied. Neighbours are only read through their original positions.
+        if (m_disableAnimateTrack)
+            return;
+        auto& tile = tiles[i];
+        const auto progress = [&tile, seconds](const double start)
+        {
+            if (tile.animationDuration <= 0)
+                return seconds >= start ? 1.0 : 0.0;
+            return std::clamp((seconds - start) / tile.animationDuration, 0.0, 1.0);
+        };
+        if (i != 0 && tile.trackAnimation != TrackAnimation::None)
+        {
+            const double y = progress(tile.appearSeconds), r = 1 - y;
+            switch (tile.trackAnimation)
+            {
+            case TrackAnimation::None:
+                break;
+            case TrackAnimation::Fade:
+                tile.opacity *= y;
+                break;
+            case TrackAnimation::Scatter:
+            case TrackAnimation::Scatter_Far:
+                tile.pos.c += scatterOffset(i, 0, tile.trackAnimation == TrackAnimation::Scatter ? 4 : 12) * r;
+                tile.opacity *= y;
+                break;
+            case TrackAnimation::Assemble:
+                tile.pos.c += scatterOffset(i, 0, 2) * r;
+                tile.rotation.c += (i % 2 == 0 ? -180 : 180) * r;
+                tile.opacity *= y;
+                break;
+            case TrackAnimation::Extend:
+                tile.pos.c += (tiles[i - 1].pos.o - tile.pos.o) * r;
+                tile.scale.c *= y;
+                break;
+            case TrackAnimation::Grow_Spin:
+                tile.rotation.c += -180 * r;
+                tile.scale.c *= y;
+                break;
+            }
+        }
+        if (i + 1 != tiles.size() && tile.trackDisappearAnimation != TrackDisappearAnimation::None)
+        {
+            const double y = progress(tile.disappearSeconds), r = 1 - y;
+            switch (tile.trackDisappearAnimation)
+            {
+            case TrackDisappearAnimation::None:
+                break;
+            case TrackDisappearAnimation::Fade:
+                tile.opacity *= r;
+                break;
+            case TrackDisappearAnimation::Scatter:
+            case TrackDisappearAnimation::Scatter_Far:
+                tile.pos.c +=
+                    scatterOffset(i, 1, tile.trackDisappearAnimation == TrackDisappearAnimation::Scatter ? 4 : 12) * y;
+                tile.opacity *= r;
+                break;
+            case TrackDisappearAnimation::Retract:
+                tile.pos.c += (tiles[i + 1].pos.o - tile.pos.o) * y;
+                tile.scale.c *= r;
+                break;
+            case TrackDisappearAnimation::Shrink_Spin:
+                tile.rotation.c += 180 * y;
+                tile.scale.c *= r;
+                break;
+            }
+        }
     }
 } // namespace AdoCpp
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <array>
+#include <concepts>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <future>
+#include <ostream>
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
 #include <rapidjson/istreamwrapper.h>
@@ -10,12 +14,18 @@
 #include <list>
 
 #include "Event.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "LevelLoad.h"
 #include "Math/Vector2.h"
 #include "Utils.h"
 #include "Tile.h"
 
 namespace AdoCpp
 {
+    class ThreadPool;
+    struct EmbeddedLevel;
+
     class LevelCouldNotOpenFileException final : public std::exception
     {
     public:
@@ -30,18 +40,96 @@ namespace AdoCpp
     {
     private:
         rapidjson::ParseErrorCode m_code;
+        std::string m_what;
+
+    public:
+        explicit LevelJsonException(const rapidjson::ParseErrorCode code) :
+            m_code(code), m_what(std::string("LevelJsonException: ") + rapidjson::GetParseError_En(code))
+        {
+        }
+        [[nodiscard]] rapidjson::ParseErrorCode code() const noexcept { return m_code; }
+        [[nodiscard]] const char* what() const noexcept override { return m_what.c_str(); }
+    };
+
+    class LevelBinaryException final : public std::exception
+    {
+    private:
+        std::string m_what;
 
     public:
-        explicit LevelJsonException(const rapidjson::ParseErrorCode code) { m_code = code; }
+        explicit LevelBinaryException(const char* reason) : m_what(std::string("LevelBinaryException: ") + reason) {}
+        [[nodiscard]] const char* what() const noexcept override { return m_what.c_str(); }
+    };
+
+    class LevelNotEmbeddedException final : public std::exception
+    {
+    public:
+        LevelNotEmbeddedException() = default;
         [[nodiscard]] const char* what() const noexcept override
         {
-            const auto msg = new char[256];
-            strcpy_s(msg, 256, "LevelCouldNotOpenFileException: could not open file");
-            strcat_s(msg, 256, rapidjson::GetParseError_En(m_code));
-            return msg;
+            return "LevelNotEmbeddedException: no level with this name is embedded into the executable";
+        }
+    };
+
+    class LevelFormatException final : public std::exception
+    {
+    private:
+        std::string m_what;
+
+    public:
+        explicit LevelFormatException(const char* reason) : m_what(std::string("LevelFormatException: ") + reason) {}
+        [[nodiscard]] const char* what() const noexcept override { return m_what.c_str(); }
+    };
+
+    /**
+     * @brief The number of events removed by Level::optimize(), by reason.
+     */
+    struct OptimizeStats
+    {
+        size_t inactive = 0;    ///< Inactive events.
+        size_t overridden = 0;  ///< Non-stackable events followed by another one of the same type on the same floor
+                                ///< (and of the same gameSound for SetHitsound).
+        size_t colorTracks = 0; ///< ColorTracks repeating the one in effect.
+        size_t moveTracks = 0;  ///< MoveTracks that set nothing.
+        size_t setSpeeds = 0;   ///< SetSpeeds that do not change the bpm or are merged into another one.
+
+        [[nodiscard]] size_t total() const noexcept
+        {
+            return inactive + overridden + colorTracks + moveTracks + setSpeeds;
         }
     };
 
+    /**
+     * Loading only throws for what makes the whole file unusable (it cannot be opened, it is not json,
+     * it has no tiles). Everything else is collected here: the action or member concerned is skipped
+     * (or keeps its default value) and the rest of the level is loaded.
+     * @brief The problems found while loading a level.
+     */
+    struct LoadDiagnostics
+    {
+        /**
+         * @brief The action index of a warning that is not about an action.
+         */
+        static constexpr size_t noAction = static_cast<size_t>(-1);
+        struct Warning
+        {
+            /**
+             * @brief The index of the action in the actions array, or noAction.
+             */
+            size_t action;
+            std::string reason;
+        };
+        std::vector<Warning> warnings;
+
+        void warn(const size_t action, std::string reason) { warnings.push_back({action, std::move(reason)}); }
+        [[nodiscard]] bool empty() const noexcept { return warnings.empty(); }
+        void clear() noexcept { warnings.clear(); }
+        /**
+         * @brief Print the warnings, one per line (the stream is flushed once at the end).
+         */
+        void print(std::ostream& os) const;
+    };
+
     /**
      * @brief Adofai's difficulty.
      */
@@ -106,10 +194,23 @@ namespace AdoCpp
         Settings() = default;
         explicit Settings(const rapidjson::Value& jsonSettings);
 
+        /**
+         * @throw std::invalid_argument If a member is missing or invalid.
+         */
         [[nodiscard]] static Settings fromJson(const rapidjson::Value& jsonSettings);
+        /**
+         * @brief Read the members of the settings (see Event::Event::read).
+         * @param reader The reader of the json object of the settings.
+         */
+        void read(JsonReader& reader);
         [[nodiscard]] std::unique_ptr<rapidjson::GenericValue<rapidjson::UTF8<>>>
         intoJson(rapidjson::Document::AllocatorType& alloc) const;
         [[nodiscard]] std::unique_ptr<rapidjson::Document> intoJson() const;
+        /**
+         * @brief Write the settings as the json object of a level's settings.
+         * @param writer The writer.
+         */
+        void write(JsonWriter& writer) const;
 
         /**
          * Apply the settings to the tile.
@@ -118,6 +219,24 @@ namespace AdoCpp
         void apply(Tile& tile) const;
     };
 
+    /**
+     * @brief What Level::peekMetadata() reads from a level file.
+     */
+    struct LevelMetadata
+    {
+        /**
+         * @brief The settings (members that are missing or invalid keep their default values).
+         */
+        Settings settings;
+        /**
+         * @brief The number of elements of angleData (or characters of pathData).
+         *
+         * A loaded level has one more tile, the one the planets start on.
+         */
+        size_t tileCount = 0;
+        size_t actionCount = 0;
+    };
+
     /**
      * @brief Planet struct.
      */
@@ -166,6 +285,12 @@ namespace AdoCpp
         explicit Level(const std::filesystem::path& path);
 
         Level(const Level&) = delete;
+        /**
+         * Moving lets a level loaded in the background (see loadAsync()) replace the one in use.
+         * @brief Move constructor.
+         */
+        Level(Level&&) noexcept = default;
+        Level& operator=(Level&&) noexcept = default;
 
         /**
          * @brief Default destructor.
@@ -184,29 +309,167 @@ namespace AdoCpp
         void defaultLevel();
 
         /**
+         * The warnings (see LoadDiagnostics) are printed to std::cout.
          * @brief Import json data into the level.
          * @param document Json data.
          */
         void fromJson(const rapidjson::Document& document);
+        /**
+         * @brief Import json data into the level.
+         * @param document Json data.
+         * @param diagnostics Receives the warnings.
+         * @throw LevelFormatException If the level has no tiles.
+         */
+        void fromJson(const rapidjson::Document& document, LoadDiagnostics& diagnostics);
 
         /**
+         * The warnings (see LoadDiagnostics) are printed to std::cout.
          * @brief Import a file into the level (encoded in UTF-8 BOM).
          * @param ifs The input file stream.
          */
         void fromFile(std::ifstream& ifs);
         /**
+         * @brief Import a file into the level (encoded in UTF-8 BOM).
+         * @param ifs The input file stream.
+         * @param diagnostics Receives the warnings.
+         */
+        void fromFile(std::ifstream& ifs, LoadDiagnostics& diagnostics);
+        /**
+         * The warnings (see LoadDiagnostics) are printed to std::cout.
          * @brief Import a file into the level (encoded in UTF-8 BOM).
          * @param path The path to the file.
          */
         void fromFile(const std::filesystem::path& path);
+        /**
+         * A level that loads with warnings is not stored into the cache (see cacheDirectory()),
+         * so they are reported again the next time.
+         * @brief Import a file into the level (encoded in UTF-8 BOM).
+         * @param path The path to the file.
+         * @param diagnostics Receives the warnings.
+         */
+        void fromFile(const std::filesystem::path& path, LoadDiagnostics& diagnostics);
+        /**
+         * The file is read, the events are decoded (see lazyDecoding()) and the level is fully parsed on the executor,
+         * while the returned handle reports the stage and progress, offers a preview of the first tiles and can
+         * cancel the load. The level must not be used until the load has finished; if it fails or is cancelled,
+         * the level is cleared and LevelLoad::get() rethrows the exception.
+         * @brief Import a file into the level in the background.
+         * @param path The path to the file.
+         * @param executor The pool the load runs on (e.g. ThreadPool::global()).
+         * @return The handle of the load.
+         */
+        [[nodiscard]] LevelLoad loadAsync(const std::filesystem::path& path, ThreadPool& executor);
+
+        /**
+         * Only settings is parsed. angleData, pathData and actions are skimmed to count their elements
+         * without building anything, the other members are skipped, and scanning stops as soon as settings,
+         * actions and angleData (or pathData) have been seen (so decorations, which usually come last, are
+         * never read).
+         * @brief Read the settings, tile count and action count of a level file without loading it.
+         * @param path The path to the file.
+         * @return The metadata.
+         * @throw LevelCouldNotOpenFileException If the file cannot be opened.
+         * @throw LevelJsonException If the settings are not valid json.
+         * @throw LevelFormatException If the file is not a json object.
+         */
+        [[nodiscard]] static LevelMetadata peekMetadata(const std::filesystem::path& path);
+
+        /**
+         * If the file holds parse results (see intoBinary), the tile timing and geometry, the tempo map and the
+         * MoveTrack tables are restored from it and the level is left parsed: only the dynamic events, which
+         * point to the events themselves, are resolved again (and the streaming source rebuilt in streaming mode).
+         * Otherwise parse() has to be called as usual.
+         * @brief Import a compiled level (see intoBinary).
+         * @param path The path to the file.
+         * @throw LevelCouldNotOpenFileException If the file cannot be opened.
+         * @throw LevelBinaryException If the file is not a valid compiled level of this version.
+         */
+        void fromBinary(const std::filesystem::path& path);
+        /**
+         * The parse results are restored as by fromBinary(const std::filesystem::path&).
+         * @brief Import a compiled level (see intoBinary).
+         * @param data The bytes of the compiled level (no alignment is required).
+         * @param size The number of bytes.
+         * @throw LevelBinaryException If the data is not a valid compiled level of this version.
+         */
+        void fromBinary(const char* data, size_t size);
+        /**
+         * Nothing is read from the disk and no json is parsed. AdoCppEmbed embeds the parse results, which are
+         * restored as by fromBinary(), so the level is left parsed.
+         * @brief Import a level embedded into the executable (see EmbeddedLevel.h).
+         * @param level The embedded level.
+         */
+        void fromEmbedded(const EmbeddedLevel& level);
+        /**
+         * @brief Import a level embedded into the executable (see EmbeddedLevel.h).
+         * @param name The name of the embedded level.
+         * @throw LevelNotEmbeddedException If no level with this name is embedded.
+         */
+        void fromEmbedded(std::string_view name);
+
+        /**
+         * Removes inactive events, keeps only the last non-stackable event of each type on a floor (of each
+         * gameSound for SetHitsound), removes ColorTracks repeating the one in effect and MoveTracks that set
+         * nothing, and replaces each run of SetSpeeds at the same moment by a single one (or none if the bpm does
+         * not change). The timing and geometry of the tiles stay the same, up to rounding for the SetSpeeds that
+         * are dropped.
+         * Stackable events are never merged, since applying one twice is not the same as applying it once.
+         * The level must be parsed again afterwards.
+         * @brief Remove the events that have no effect.
+         * @return The number of events removed.
+         */
+        OptimizeStats optimize();
+        /**
+         * The format is described in LevelBinary.h. The parse results (tile timing and geometry, the tempo map
+         * and the MoveTrack tables) are included if the level has been fully parsed; fromBinary() restores them
+         * and Binary::CompiledLevel reads them in place.
+         * @brief Export the level as a compiled level.
+         * @param parseResults Whether to include the parse results.
+         * @return The bytes of the compiled level.
+         */
+        [[nodiscard]] std::vector<char> intoBinary(bool parseResults = true) const;
+        /**
+         * @brief Export the level as a compiled level file.
+         * @param path The path to the file.
+         * @param parseResults Whether to include the parse results.
+         */
+        void intoBinary(const std::filesystem::path& path, bool parseResults = true) const;
 
         [[nodiscard]] std::unique_ptr<rapidjson::Value> intoJson(rapidjson::Document::AllocatorType& alloc) const;
         [[nodiscard]] std::unique_ptr<rapidjson::Document> intoJson() const;
+        /**
+         * Nothing is built in memory: the angles, settings and events are written one after another.
+         * @brief Write the level as json.
+         * @param writer The writer.
+         */
+        void write(JsonWriter& writer) const;
+        /**
+         * @brief Write the level as json into a rapidjson Writer or PrettyWriter.
+         * @param writer The rapidjson writer (e.g. a PrettyWriter over a file stream).
+         */
+        template <typename Writer>
+            requires(!std::derived_from<Writer, JsonWriter>)
+        void write(Writer& writer) const
+        {
+            RapidJsonWriter<Writer> jsonWriter(writer);
+            write(static_cast<JsonWriter&>(jsonWriter));
+        }
 
         /**
+         * A full parse first decodes the deferred events (see lazyDecoding()); a basic one does not need them.
          * @brief Parse the level.
          */
         void parse(size_t floorStart = 0, bool basic = false, bool force = false);
+        /**
+         * @brief Decode the deferred events (see lazyDecoding()), printing the invalid actions to std::cout.
+         */
+        void decodeEvents();
+        /**
+         * The invalid actions are removed from their tiles.
+         * @brief Decode the deferred events (see lazyDecoding()).
+         * @param diagnostics Receives a warning for each invalid action.
+         */
+        void decodeEvents(LoadDiagnostics& diagnostics);
 
         /**
          * @brief Update the level.
@@ -407,9 +670,93 @@ namespace AdoCpp
          */
         void updateCamera(double seconds, size_t floor);
 
+        /**
+         * Track animations are evaluated by update() on top of the MoveTracks: positions and rotations are offset,
+         * scales and opacities are multiplied. On a tile that no MoveTrack touches, Fade, Grow_Spin and Shrink_Spin
+         * look as they did when they were generated as MoveTracks; on a tile whose opacity, scale or rotation is
+         * also moved by a MoveTrack, the result differs from easing one MoveTrack into the other.
+         * @brief Whether track animations are ignored.
+         */
         bool disableAnimateTrack() const;
         void disableAnimateTrack(bool disable);
 
+        /**
+         * @brief Whether update(double) spreads the tiles over the thread pool.
+         */
+        bool parallelUpdate() const;
+        void parallelUpdate(bool enable);
+        /**
+         * @brief The number of tiles below which update(double) stays serial even in parallel mode.
+         */
+        size_t parallelUpdateThreshold() const;
+        void parallelUpdateThreshold(size_t threshold);
+        /**
+         * Loading builds the events of at least this many actions on the thread pool.
+         * They are still added to the tiles in the order of the actions array.
+         * @brief The number of actions from which they are decoded in parallel.
+         */
+        size_t parallelDecodeThreshold() const;
+        void parallelDecodeThreshold(size_t threshold);
+        /**
+         * Writing at least this many actions splits them into floor ranges that are written into their own buffers
+         * on the thread pool, then appended in order; the output is the same as the serial one. Only writers that
+         * support chunks (see JsonWriter::supportsChunks) are written in parallel.
+         * @brief The number of actions from which they are written in parallel.
+         */
+        size_t parallelWriteThreshold() const;
+        void parallelWriteThreshold(size_t threshold);
+        /**
+         * When enabled, write() writes the tiles as a pathData string if every angle has a pathData character,
+         * which is several times smaller than angleData. Otherwise (or when disabled) it writes angleData.
+         * @brief Whether write() prefers pathData to angleData.
+         */
+        bool writePathData() const;
+        void writePathData(bool enable);
+        /**
+         * When enabled, loading only decodes floor and active of the actions a basic parse does not need
+         * (see Event::deferrableEventType()) and keeps them as Event::Deferred until decodeEvents() or a full parse.
+         * Tools that only need timing and tile geometry then skip most of the decoding.
+         * @brief Whether loading defers the decoding of the actions.
+         */
+        bool lazyDecoding() const;
+        void lazyDecoding(bool enable);
+
+        /**
+         * In streaming mode the per-tile MoveTrack data and the RecolorTrack list are only built for the tiles
+         * within this many seconds of the playhead, and update(double) only evaluates those tiles. The window is
+         * extended in the background as the playhead moves forward. Tile geometry and timing are still parsed for
+         * the whole level, but the MoveTracks and RecolorTracks (with their repetitions) are resolved window by
+         * window, by scanning the floors the window covers. parse() only resolves the few that scan may miss:
+         * those starting before their floor, repeated backward or reaching far beyond it. The MoveTrack and
+         * RecolorTrack events themselves are left without seconds and beat in streaming mode.
+         * @brief The half width of the streaming window in seconds (0 disables streaming).
+         */
+        double streamingWindow() const;
+        void streamingWindow(double seconds);
+        /**
+         * @brief Get the tiles kept up to date by update(double).
+         * @return The range [first, second) (every tile when streaming is disabled).
+         */
+        [[nodiscard]] std::pair<size_t, size_t> streamingRange() const;
+
+        /**
+         * When set, fromFile(path) first looks for a compiled copy of the file in this directory, named after
+         * the hash of the file contents and the compiled format version, and stores one after reading JSON.
+         * A cache file holds the level with its parse results (see fromBinary()), so a cache hit skips the
+         * reading and decoding of the json and most of parse(). On a cache miss the level is therefore parsed by
+         * fromFile(path), deferred events included (see lazyDecoding()).
+         * @brief The directory of the level cache (empty disables the cache).
+         */
+        const std::filesystem::path& cacheDirectory() const;
+        void cacheDirectory(const std::filesystem::path& directory);
+        /**
+         * After a level is stored into the cache, the least recently used cache files (a cache hit counts as
+         * a use) are removed until the cache files of the directory fit in this many bytes.
+         * @brief The size limit of the level cache in bytes (0 for no limit).
+         */
+        uintmax_t cacheSizeLimit() const;
+        void cacheSizeLimit(uintmax_t bytes);
+
         /**
          * @brief The level's settings.
          */
@@ -420,6 +767,13 @@ namespace AdoCpp
          */
         std::vector<Tile> tiles;
 
+        /**
+         * The decorations are not decoded: they are kept as compact json and written back as they were
+         * (an empty string is written as an empty array).
+         * @brief The level's decorations array as json.
+         */
+        std::string decorations;
+
     protected: // I do not know if I should use private or protected
         /**
          * @brief Whether the level has been parsed.
@@ -427,18 +781,209 @@ namespace AdoCpp
         bool parsed = false;
         bool onlyBasic = false;
         bool m_disableAnimateTrack = false;
+        bool m_parallelUpdate = false;
+        size_t m_parallelUpdateThreshold = 4096;
+        size_t m_parallelDecodeThreshold = 16384;
+        size_t m_parallelWriteThreshold = 16384;
+        bool m_writePathData = true;
+        bool m_lazyDecoding = false;
+        bool m_hasDeferredEvents = false;
+        double m_streamingWindow = 0;
+        std::filesystem::path m_cacheDirectory;
+        uintmax_t m_cacheSizeLimit = 256 << 20;
 
     private:
+        friend class LevelReader;
+
+        /**
+         * @brief Build the events of some actions (in parallel if there are enough of them).
+         * @param actions The first action.
+         * @param count The number of actions.
+         * @param firstIndex The index of the first action in the actions array.
+         * @param diagnostics Receives a warning for each invalid action, in order.
+         * @return The events in the order of the actions (unsupported ones are Event::Unknown, deferred
+         * ones Event::Deferred and invalid ones nullptr).
+         */
+        [[nodiscard]] std::vector<std::shared_ptr<Event::Event>>
+        newEvents(const rapidjson::Value* actions, size_t count, size_t firstIndex, LoadDiagnostics& diagnostics);
+        /**
+         * @brief Keep an action as an Event::Deferred if its decoding can be deferred.
+         * @param action The action.
+         * @param actionIndex The index of the action in the actions array.
+         * @param copies The array the action is copied into (created with the given capacity if it is null).
+         * @param capacity The number of actions the array is created for.
+         * @return The event, or nullptr if the action has to be decoded now.
+         */
+        [[nodiscard]] static std::shared_ptr<Event::Deferred>
+        deferEvent(const rapidjson::Value& action, size_t actionIndex, std::shared_ptr<rapidjson::Document>& copies,
+                   size_t capacity);
+        /**
+         * @brief Read the settings, keeping the default value of the members that are missing or invalid.
+         */
+        void readSettings(const rapidjson::Value& json, LoadDiagnostics& diagnostics);
+        /**
+         * @brief Add the tiles of pathData (an invalid character is skipped with a warning).
+         */
+        void addPathTiles(std::string_view pathData, LoadDiagnostics& diagnostics);
+        /**
+         * @brief Get the tiles' angles as pathData.
+         * @return Whether every angle has a pathData character (out is unspecified otherwise).
+         */
+        bool encodePathData(std::string& out) const;
+        /**
+         * @brief The warning for an event whose floor is not a tile of the level.
+         */
+        [[nodiscard]] static std::string floorOutOfRange(const Event::Event& event);
+        /**
+         * @brief The number of consecutive actions a worker decodes at a time.
+         */
+        static constexpr size_t parallelDecodeGrain = 1024;
+
+        /**
+         * @brief Write the events of every tile as the elements of the actions array.
+         */
+        void writeActions(JsonWriter& writer) const;
+        /**
+         * @brief The number of actions a worker writes into a chunk (whole tiles are kept together).
+         */
+        static constexpr size_t parallelWriteGrain = 2048;
+
+        /**
+         * @brief Import a file into the level, reporting the progress of the json stage if progress is not null.
+         */
+        void load(const std::filesystem::path& path, LoadDiagnostics& diagnostics, LoadProgress* progress);
+
+        /**
+         * @brief Load the level from a cache file.
+         * @return Whether the file exists and is a valid compiled level.
+         */
+        bool loadCache(const std::filesystem::path& path);
+        /**
+         * @brief Parse the level, store it into a cache file and evict old ones (failures are ignored).
+         */
+        void storeCache(const std::filesystem::path& path);
+
+        /**
+         * @brief Restore the parse results of a compiled level (see fromBinary).
+         * @throw LevelBinaryException If they do not match the tiles and events.
+         */
+        void restoreParseResults(std::string_view tileResults, std::string_view tempoMap, std::string_view moveTracks,
+                                 uint32_t flags);
+
         void parseTiles(size_t beginFloor = 0);
+        void collectSetSpeeds();
         void parseSetSpeed();
+        /**
+         * @brief Resolve the dynamic events and their repetitions into m_processedDynamicEvents, in beat order.
+         */
+        void resolveDynamicEvents();
         void parseDynamicEvents(std::vector<Event::DynamicEvent*>& dynamicEvents,
                                 std::vector<std::vector<Event::Modifiers::RepeatEvents*>>& vecRe);
         void parseAnimateTrack();
         void parseRepeatEvents(const std::vector<Event::DynamicEvent*>& dynamicEvents,
                                const std::vector<std::vector<Event::Modifiers::RepeatEvents*>>& vecRe);
         void parseMoveTrackData();
+        /**
+         * @brief Resolve the MoveTracks and RecolorTracks the windows cannot find by scanning their floors.
+         */
+        void parseStreamingSource();
+
+        /**
+         * @brief The beat and seconds of the first tile while parsing (parse() leaves them at -infinity).
+         */
+        [[nodiscard]] std::pair<double, double> firstTileTime() const;
+        /**
+         * @brief The seconds and beat of a dynamic event on a floor (see parseDynamicEvents).
+         */
+        [[nodiscard]] std::pair<double, double> dynamicEventTime(size_t floor, double angleOffset, size_t& bpmHint,
+                                                                 size_t& secondsHint) const;
+        /**
+         * @brief Call repeat(repetition, floor, seconds, beat) for each repetition of an event by a RepeatEvents.
+         * @param floor The floor of the event.
+         * @param seconds The seconds of the event.
+         * @param beat The beat of the event.
+         */
+        template <typename F>
+        void repeatEvent(const Event::Modifiers::RepeatEvents& repeatEvents, size_t floor, double angleOffset,
+                         double seconds, double beat, size_t& bpmHint, size_t& secondsHint, F repeat) const;
+
+        /**
+         * @brief The number of tiles past its floor a MoveTrack or RecolorTrack may reach and still be found by
+         * the floor scan of the streaming windows. The others are resolved by parse().
+         */
+        static constexpr size_t streamingTrackReach = 256;
+        /**
+         * The repetitions come first at the same beat, the last one created first, then the events in level order.
+         * @brief The position of a MoveTrack or RecolorTrack in the processing order of parse().
+         */
+        struct TrackOrder
+        {
+            double beat;
+            bool repetition;
+            // The floor and index of the event, then for a repetition the index of the RepeatEvents, of the tag,
+            // of the event tag and the repetition.
+            std::array<size_t, 6> creation;
+            bool operator<(const TrackOrder& other) const;
+        };
+        /**
+         * Only the MoveTracks and RecolorTracks a window needs are resolved, and copied so the background builds
+         * never read events the level may be changing.
+         * @brief Resolved MoveTracks and RecolorTracks in processing order.
+         */
+        struct StreamingSource
+        {
+            struct MoveTrack
+            {
+                size_t begin, end; // inclusive
+                TrackOrder order;
+                Tile::MoveTrackData data;
+            };
+            struct RecolorTrack
+            {
+                size_t begin, end; // inclusive
+                TrackOrder order;
+                std::shared_ptr<const Event::Track::RecolorTrack> event; // only dereferenced by the level itself
+            };
+            std::vector<MoveTrack> moveTracks;
+            std::vector<RecolorTrack> recolorTracks;
+        };
+        /**
+         * @brief The data of the tiles [begin, end), valid while the playhead is in [anchor, anchor + 2 * window].
+         */
+        struct StreamingWindow
+        {
+            double anchor = std::numeric_limits<double>::quiet_NaN();
+            size_t begin = 0, end = 0;
+            std::vector<std::vector<Tile::MoveTrackData>> moveTrackDatas;
+            std::vector<std::shared_ptr<const Event::Track::RecolorTrack>> recolorTracks;
+        };
+        /**
+         * A track is far if the floor scan of the windows may miss it or one of its repetitions.
+         * @brief Resolve the far (or the other) MoveTracks and RecolorTracks of a floor, with their repetitions.
+         */
+        void collectStreamingTracks(size_t floor, bool far, size_t& bpmHint, size_t& secondsHint,
+                                    size_t& repeatHint, double lastSeconds, size_t begin, size_t end,
+                                    StreamingSource& source) const;
+        /**
+         * @brief Resolve the MoveTracks and RecolorTracks of the window anchored at this moment.
+         */
+        [[nodiscard]] std::shared_ptr<const StreamingSource> streamingSource(double anchor, size_t begin,
+                                                                             size_t end) const;
+        [[nodiscard]] static StreamingWindow buildStreamingWindow(const std::shared_ptr<const StreamingSource>& source,
+                                                                  double anchor, double window, size_t begin,
+                                                                  size_t end);
+        [[nodiscard]] std::pair<size_t, size_t> streamingFloors(double anchor) const;
+        [[nodiscard]] bool streamingCovers(const StreamingWindow& window, double seconds) const;
+        void updateStreamingWindow(double seconds);
+        void applyStreamingWindow(StreamingWindow&& window);
+
+        /**
+         * @brief The number of consecutive tiles a worker updates at a time.
+         */
+        static constexpr size_t parallelUpdateGrain = 512;
 
-        void updateTileColorInfo(const Event::Track::RecolorTrack* recolorTrack);
+        void updateTileColorInfo(const Event::Track::RecolorTrack* recolorTrack, size_t first = 0,
+                                 size_t last = -1ull);
         void updateTileColor(double seconds, size_t i);
         void updateTilePos(double seconds, size_t i);
 
@@ -463,8 +1008,61 @@ namespace AdoCpp
             Easing ease;
         };
 
+        /**
+         * @brief Per-floor working storage of parse(). It only grows, so reparsing does not allocate.
+         */
+        struct ParseScratch
+        {
+            // clang-format off
+            std::vector<bool>                                         twirls;
+            std::vector<double>                                       pauses;
+            std::vector<const Event::GamePlay::SetHitsound*>          setHitsounds;
+            std::vector<const Event::Track::PositionTrack*>           positionTracks;
+            std::vector<const Event::Track::ColorTrack*>              colorTracks;
+            std::vector<const Event::Track::AnimateTrack*>            animateTracks;
+            std::vector<const Event::Dlc::Hold*>                      holds;
+            std::vector<Event::DynamicEvent*>                         dynamicEvents;
+            std::vector<Event::DynamicEvent*>                         sweep;
+            std::vector<std::vector<Event::Modifiers::RepeatEvents*>> vecRe;
+            // clang-format on
+        } m_scratch;
+
+        /**
+         * @brief A span of constant bpm starting at a SetSpeed (the first one starts at beat 0 with settings.bpm).
+         */
+        struct TempoSegment
+        {
+            size_t floor;
+            double angleOffset;
+            double beat;
+            double seconds;
+            double bpm;
+        };
+
+        /**
+         * @brief Find the last tempo segment for which applies() holds (0 if none).
+         * @param applies Whether a segment has started; must be true for a prefix of the segments.
+         */
+        template <typename Pred>
+        [[nodiscard]] size_t findTempoSegment(Pred applies) const;
+        /**
+         * @brief Find the last tempo segment for which applies() holds (0 if none), walking from the hint.
+         * Queries made in ascending order through the same hint cost O(1) amortized.
+         * @param applies Whether a segment has started; must be true for a prefix of the segments.
+         * @param hint The segment found by the previous query; updated to the result.
+         */
+        template <typename Pred>
+        [[nodiscard]] size_t findTempoSegment(Pred applies, size_t& hint) const;
+        [[nodiscard]] double seconds2beat(double seconds, size_t& hint) const;
+
         std::list<std::shared_ptr<Event::DynamicEvent>> m_processedDynamicEvents;
         std::vector<std::shared_ptr<Event::GamePlay::SetSpeed>> m_setSpeeds;
+        std::vector<TempoSegment> m_tempoSegments;
+
+        std::shared_ptr<const StreamingSource> m_farTracks;
+        StreamingWindow m_window;
+        std::future<StreamingWindow> m_nextWindow;
+        double m_nextWindowAnchor{};
         std::vector<MoveCameraData> m_moveCameraDatas;
 
         struct Camera
@@ -0,0 +1,840 @@
+#include "LevelBinary.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <tuple>
+
+#include "Event.h"
+#include "Level.h"
+#include "NameTable.h"
+
+namespace AdoCpp::Binary
+{
+    namespace
+    {
+        // The tags are stored in the files: only append to the list.
+        // clang-format off
+        constexpr const char* const cstrEventTag[] = {
+            "SetSpeed", "Twirl", "Pause", "SetHitsound", "SetPlanetRotation",
+            "ColorTrack", "AnimateTrack", "RecolorTrack", "PositionTrack", "MoveTrack",
+            "MoveCamera",
+            "RepeatEvents",
+            "Hold",
+            "Unknown",
+        };
+        using EventTypes = std::tuple<
+            Event::GamePlay::SetSpeed, Event::GamePlay::Twirl, Event::GamePlay::Pause,
+            Event::GamePlay::SetHitsound, Event::GamePlay::SetPlanetRotation,
+            Event::Track::ColorTrack, Event::Track::AnimateTrack, Event::Track::RecolorTrack,
+            Event::Track::PositionTrack, Event::Track::MoveTrack,
+            Event::Visual::MoveCamera,
+            Event::Modifiers::RepeatEvents,
+            Event::Dlc::Hold,
+            Event::Unknown>;
+        // clang-format on
+        static_assert(std::size(cstrEventTag) == std::tuple_size_v<EventTypes>);
+        constexpr NameTable eventTagNames(cstrEventTag);
+
+        class Writer
+        {
+        public:
+            Writer(std::vector<char>& data, std::vector<char>& strings) : m_data(data), m_strings(strings) {}
+
+            template <typename T>
+                requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+            void operator()(const T& value)
+            {
+                const auto bytes = reinterpret_cast<const char*>(&value);
+                m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+            }
+            void operator()(const std::string& str)
+            {
+                (*this)(StringRef{static_cast<uint32_t>(m_strings.size()), static_cast<uint32_t>(str.size())});
+                m_strings.insert(m_strings.end(), str.begin(), str.end());
+            }
+            void operator()(const StringRef& ref)
+            {
+                (*this)(ref.offset);
+                (*this)(ref.length);
+            }
+            template <typename T>
+            void operator()(const std::vector<T>& values)
+            {
+                (*this)(static_cast<uint32_t>(values.size()));
+                for (const auto& value : values)
+                    (*this)(value);
+            }
+            template <typename T, typename U>
+            void operator()(const std::pair<T, U>& pair)
+            {
+                (*this)(pair.first), (*this)(pair.second);
+            }
+            template <typename T>
+            void operator()(const std::optional<T>& optional)
+            {
+                (*this)(static_cast<uint8_t>(optional.has_value()));
+                if (optional)
+                    (*this)(*optional);
+            }
+            void operator()(const Color& color)
+            {
+                (*this)(color.r), (*this)(color.g), (*this)(color.b), (*this)(color.a);
+            }
+            void operator()(const Vector2lf& vector) { (*this)(vector.x), (*this)(vector.y); }
+            void operator()(const RelativeIndex& index) { (*this)(index.index), (*this)(index.relativeTo); }
+            void operator()(const OptionalPoint& point) { (*this)(point.first), (*this)(point.second); }
+
+        private:
+            std::vector<char>& m_data;
+            std::vector<char>& m_strings;
+        };
+
+        // The range of an enumeration stored in the files, so that a corrupt value is rejected.
+        template <typename E>
+        constexpr std::pair<int, int> enumRange()
+        {
+            namespace GamePlay = Event::GamePlay;
+            if constexpr (std::is_same_v<E, Easing>)
+                return {0, static_cast<int>(std::size(cstrEasing)) - 1};
+            else if constexpr (std::is_same_v<E, Hitsound>)
+                return {0, static_cast<int>(std::size(cstrHitsound)) - 1};
+            else if constexpr (std::is_same_v<E, TrackColorType>)
+                return {0, static_cast<int>(std::size(cstrTrackColorType)) - 1};
+            else if constexpr (std::is_same_v<E, TrackStyle>)
+                return {0, static_cast<int>(std::size(cstrTrackStyle)) - 1};
+            else if constexpr (std::is_same_v<E, TrackAnimation>)
+                return {0, static_cast<int>(std::size(cstrTrackAnimation)) - 1};
+            else if constexpr (std::is_same_v<E, TrackDisappearAnimation>)
+                return {0, static_cast<int>(std::size(cstrTrackDisappearAnimation)) - 1};
+            else if constexpr (std::is_same_v<E, TrackColorPulse>)
+                return {-1, 1};
+            else if constexpr (std::is_same_v<E, Orbit>)
+                return {0, 1};
+            else if constexpr (std::is_same_v<E, RelativeToTile>)
+                return {0, static_cast<int>(std::size(cstrRelativeToTile)) - 1};
+            else if constexpr (std::is_same_v<E, RelativeToCamera>)
+                return {0, static_cast<int>(std::size(cstrRelativeToCamera)) - 1};
+            else if constexpr (std::is_same_v<E, GamePlay::SetSpeed::SpeedType> ||
+                               std::is_same_v<E, GamePlay::SetHitsound::GameSound> ||
+                               std::is_same_v<E, GamePlay::SetPlanetRotation::EasePartBehavior> ||
+                               std::is_same_v<E, Event::Modifiers::RepeatEvents::RepeatType>)
+                return {0, 1};
+            else if constexpr (std::is_same_v<E, GamePlay::Pause::AngleCorrectionDir>)
+                return {-1, 1};
+            else
+                static_assert(sizeof(E) == 0, "the range of this enumeration is unknown");
+        }
+        template <typename E>
+        E checkedEnum(const int64_t value)
+        {
+            if (constexpr auto range = enumRange<E>(); value < range.first || value > range.second)
+                throw LevelBinaryException("enumerator out of range");
+            return static_cast<E>(value);
+        }
+
+        void toRgba(const Color& color, uint8_t (&rgba)[4])
+        {
+            rgba[0] = color.r, rgba[1] = color.g, rgba[2] = color.b, rgba[3] = color.a;
+        }
+        Color fromRgba(const uint8_t (&rgba)[4]) { return {rgba[0], rgba[1], rgba[2], rgba[3]}; }
+
+        class Reader
+        {
+        public:
+            Reader(const char* begin, const char* end, const std::string_view strings) :
+                m_cur(begin), m_end(end), m_strings(strings)
+            {
+            }
+
+            template <typename T>
+                requires std::is_arithmetic_v<T>
+            void operator()(T& value)
+            {
+                if (remaining() < sizeof(T))
+                    throw LevelBinaryException("truncated record");
+                if constexpr (std::is_same_v<T, bool>)
+                {
+                    uint8_t byte;
+                    std::memcpy(&byte, m_cur, sizeof(byte));
+                    if (byte > 1)
+                        throw LevelBinaryException("invalid boolean");
+                    value = byte;
+                }
+                else
+                    std::memcpy(&value, m_cur, sizeof(T));
+                m_cur += sizeof(T);
+            }
+            template <typename T>
+                requires std::is_enum_v<T>
+            void operator()(T& value)
+            {
+                std::underlying_type_t<T> underlying;
+                (*this)(underlying);
+                value = checkedEnum<T>(underlying);
+            }
+            void operator()(std::string& str)
+            {
+                StringRef ref{};
+                (*this)(ref);
+                if (ref.offset > m_strings.size() || ref.length > m_strings.size() - ref.offset)
+                    throw LevelBinaryException("string out of range");
+                str.assign(m_strings.substr(ref.offset, ref.length));
+            }
+            void operator()(StringRef& ref)
+            {
+                (*this)(ref.offset);
+                (*this)(ref.length);
+            }
+            template <typename T>
+            void operator()(std::vector<T>& values)
+            {
+                uint32_t size;
+                (*this)(size);
+                // Every element takes at least a byte, so a larger count cannot be valid.
+                if (size > remaining())
+                    throw LevelBinaryException("truncated record");
+                values.resize(size);
+                for (auto& value : values)
+                    (*this)(value);
+            }
+            template <typename T, typename U>
+            void operator()(std::pair<T, U>& pair)
+            {
+                (*this)(pair.first), (*this)(pair.second);
+            }
+            template <typename T>
+            void operator()(std::optional<T>& optional)
+            {
+                uint8_t hasValue;
+                (*this)(hasValue);
+                if (hasValue)
+                    (*this)(optional.emplace());
+                else
+                    optional.reset();
+            }
+            void operator()(Color& color) { (*this)(color.r), (*this)(color.g), (*this)(color.b), (*this)(color.a); }
+            void operator()(Vector2lf& vector) { (*this)(vector.x), (*this)(vector.y); }
+            void operator()(RelativeIndex& index) { (*this)(index.index), (*this)(index.relativeTo); }
+            void operator()(OptionalPoint& point) { (*this)(point.first), (*this)(point.second); }
+
+        private:
+            [[nodiscard]] size_t remaining() const noexcept { return static_cast<size_t>(m_end - m_cur); }
+
+            const char* m_cur;
+            const char* m_end;
+            std::string_view m_strings;
+        };
+
+        /**
+         * @brief Visit the stored fields of an event (E may be const for writing).
+         */
+        template <typename IO, typename E>
+        void transfer(IO& io, E& e)
+        {
+            using T = std::remove_const_t<E>;
+            namespace GamePlay = Event::GamePlay;
+            namespace Track = Event::Track;
+
+            io(e.floor), io(e.active);
+            if constexpr (std::is_base_of_v<Event::DynamicEvent, T>)
+                io(e.angleOffset), io(e.eventTag);
+
+            if constexpr (std::is_same_v<T, GamePlay::SetSpeed>)
+                io(e.speedType), io(e.beatsPerMinute), io(e.bpmMultiplier);
+            else if constexpr (std::is_same_v<T, GamePlay::Pause>)
+                io(e.duration), io(e.countdownTicks), io(e.angleCorrectionDir);
+            else if constexpr (std::is_same_v<T, GamePlay::SetHitsound>)
+                io(e.gameSound), io(e.hitsound), io(e.hitsoundVolume);
+            else if constexpr (std::is_same_v<T, GamePlay::SetPlanetRotation>)
+                io(e.ease), io(e.easeParts), io(e.easePartBehavior);
+            else if constexpr (std::is_same_v<T, Track::ColorTrack>)
+                io(e.trackColorType), io(e.trackColor), io(e.secondaryTrackColor), io(e.trackColorAnimDuration),
+                    io(e.trackColorPulse), io(e.trackPulseLength), io(e.trackStyle), io(e.trackTexture),
+                    io(e.trackGlowIntensity);
+            else if constexpr (std::is_same_v<T, Track::AnimateTrack>)
+                io(e.trackAnimation), io(e.beatsAhead), io(e.trackDisappearAnimation), io(e.beatsBehind);
+            else if constexpr (std::is_same_v<T, Track::RecolorTrack>)
+                io(e.startTile), io(e.endTile), io(e.gapLength), io(e.duration), io(e.trackColorType),
+                    io(e.trackColor), io(e.secondaryTrackColor), io(e.trackColorAnimDuration), io(e.trackColorPulse),
+                    io(e.trackPulseLength), io(e.trackStyle), io(e.trackGlowIntensity), io(e.ease);
+            else if constexpr (std::is_same_v<T, Track::PositionTrack>)
+                io(e.positionOffset), io(e.relativeTo), io(e.rotation), io(e.scale), io(e.opacity),
+                    io(e.justThisTile), io(e.editorOnly), io(e.stickToFloors);
+            else if constexpr (std::is_same_v<T, Track::MoveTrack>)
+                io(e.startTile), io(e.endTile), io(e.duration), io(e.positionOffset), io(e.rotationOffset),
+                    io(e.scale), io(e.opacity), io(e.ease);
+            else if constexpr (std::is_same_v<T, Event::Visual::MoveCamera>)
+                io(e.duration), io(e.relativeTo), io(e.position), io(e.rotation), io(e.zoom), io(e.ease);
+            else if constexpr (std::is_same_v<T, Event::Modifiers::RepeatEvents>)
+                io(e.repeatType), io(e.repetitions), io(e.floorCount), io(e.interval), io(e.executeOnCurrentFloor),
+                    io(e.tag), io(e.duration);
+            else if constexpr (std::is_same_v<T, Event::Dlc::Hold>)
+                io(e.duration), io(e.distanceMultiplier), io(e.landingAnimation);
+            else if constexpr (std::is_same_v<T, Event::Unknown>)
+                io(e.eventType), io(e.members);
+        }
+
+        template <typename IO, typename S>
+        void transferSettings(IO& io, S& s)
+        {
+            io(s.version), io(s.artist), io(s.song), io(s.author), io(s.separateCountdownTime), io(s.songFilename),
+                io(s.bpm), io(s.volume), io(s.offset), io(s.pitch), io(s.hitsound), io(s.hitsoundVolume),
+                io(s.countdownTicks), io(s.trackColorType), io(s.trackColor), io(s.secondaryTrackColor),
+                io(s.trackColorAnimDuration), io(s.trackColorPulse), io(s.trackPulseLength), io(s.trackStyle),
+                io(s.trackAnimation), io(s.beatsAhead), io(s.trackDisappearAnimation), io(s.beatsBehind),
+                io(s.backgroundColor), io(s.stickToFloors), io(s.unscaledSize), io(s.relativeTo), io(s.position),
+                io(s.rotation), io(s.zoom);
+        }
+
+        template <size_t I = 0>
+        void writeEvent(const size_t tag, const Event::Event& event, Writer& writer)
+        {
+            if constexpr (I < std::tuple_size_v<EventTypes>)
+            {
+                if (tag == I)
+                    transfer(writer, static_cast<const std::tuple_element_t<I, EventTypes>&>(event));
+                else
+                    writeEvent<I + 1>(tag, event, writer);
+            }
+        }
+        template <size_t I = 0>
+        Event::Event* readEvent(const size_t tag, Reader& reader)
+        {
+            if constexpr (I < std::tuple_size_v<EventTypes>)
+            {
+                if (tag != I)
+                    return readEvent<I + 1>(tag, reader);
+                auto event = std::make_unique<std::tuple_element_t<I, EventTypes>>();
+                transfer(reader, *event);
+                return event.release();
+            }
+            else
+                return nullptr;
+        }
+
+        void align(std::vector<char>& data)
+        {
+            data.resize((data.size() + 7) / 8 * 8);
+        }
+    } // namespace
+
+    uint64_t contentHash(const char* data, const size_t size, const uint64_t seed) noexcept
+    {
+        uint64_t hash = 14695981039346656037ull ^ seed;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+    std::string cacheFileName(const char* data, const size_t size)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx-v%u.adocache",
+                      static_cast<unsigned long long>(contentHash(data, size, formatVersion)), formatVersion);
+        return name;
+    }
+
+    std::optional<Header> readHeader(const char* data, const size_t size) noexcept
+    {
+        if (size < sizeof(Header))
+            return std::nullopt;
+        Header header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != formatVersion ||
+            header.byteOrder != byteOrderMark || header.fileSize != size)
+            return std::nullopt;
+        for (const auto& [offset, sectionSize] : header.sections)
+            if (offset % 8 != 0 || offset > size || sectionSize > size - offset)
+                return std::nullopt;
+        const auto& angles = header.sections[static_cast<size_t>(Section::Angles)];
+        const auto& tileResults = header.sections[static_cast<size_t>(Section::TileResults)];
+        if (angles.size % sizeof(double) != 0 || tileResults.size % sizeof(TileRecord) != 0 ||
+            header.sections[static_cast<size_t>(Section::TempoMap)].size % sizeof(TempoRecord) != 0 ||
+            header.sections[static_cast<size_t>(Section::MoveTracks)].size % sizeof(MoveTrackRecord) != 0)
+            return std::nullopt;
+        if (tileResults.size != 0 && tileResults.size / sizeof(TileRecord) != angles.size / sizeof(double))
+            return std::nullopt;
+        return header;
+    }
+
+    CompiledLevel::CompiledLevel(const std::filesystem::path& path) { open(path); }
+    bool CompiledLevel::open(const std::filesystem::path& path)
+    {
+        m_header.reset();
+        if (!m_file.open(path))
+            return false;
+        // The mapping is page aligned, so the records can be used in place.
+        m_header = readHeader(m_file.data(), m_file.size());
+        if (!m_header)
+            m_file.close();
+        return m_header.has_value();
+    }
+    bool CompiledLevel::isOpen() const noexcept { return m_header.has_value(); }
+    const char* CompiledLevel::data() const noexcept { return m_file.data(); }
+    size_t CompiledLevel::size() const noexcept { return m_file.size(); }
+    bool CompiledLevel::hasParseResults() const noexcept { return m_header && m_header->flags & HasParseResults; }
+    size_t CompiledLevel::tileCount() const noexcept { return angles().size(); }
+    size_t CompiledLevel::eventCount() const noexcept
+    {
+        const auto events = section<char>(Section::Events);
+        uint64_t count = 0;
+        if (events.size() >= sizeof(count))
+            std::memcpy(&count, events.data(), sizeof(count));
+        return count;
+    }
+    std::span<const double> CompiledLevel::angles() const noexcept { return section<double>(Section::Angles); }
+    std::span<const TileRecord> CompiledLevel::tileResults() const noexcept
+    {
+        return section<TileRecord>(Section::TileResults);
+    }
+    std::span<const TempoRecord> CompiledLevel::tempoMap() const noexcept
+    {
+        return section<TempoRecord>(Section::TempoMap);
+    }
+    std::span<const MoveTrackRecord> CompiledLevel::moveTracks() const noexcept
+    {
+        return section<MoveTrackRecord>(Section::MoveTracks);
+    }
+    std::string_view CompiledLevel::string(const StringRef ref) const noexcept
+    {
+        const auto strings = section<char>(Section::Strings);
+        if (ref.offset > strings.size() || ref.length > strings.size() - ref.offset)
+            return {};
+        return {strings.data() + ref.offset, ref.length};
+    }
+    template <typename T>
+    std::span<const T> CompiledLevel::section(const Section section) const noexcept
+    {
+        if (!m_header)
+            return {};
+        const auto& [offset, size] = m_header->sections[static_cast<size_t>(section)];
+        return {reinterpret_cast<const T*>(m_file.data() + offset), size / sizeof(T)};
+    }
+} // namespace AdoCpp::Binary
+
+namespace AdoCpp
+{
+    using namespace Binary;
+
+    void Level::fromBinary(const std::filesystem::path& path)
+    {
+        MappedFile file;
+        if (!file.open(path))
+            throw LevelCouldNotOpenFileException();
+        fromBinary(file.data(), file.size());
+    }
+    void Level::fromBinary(const char* data, const size_t size)
+    {
+        clear();
+        const auto header = readHeader(data, size);
+        if (!header)
+            throw LevelBinaryException("not a compiled level of this version");
+        const auto sectionData = [data, &header](const Section section)
+        {
+            const auto& [offset, size] = header->sections[static_cast<size_t>(section)];
+            return std::string_view(data + offset, size);
+        };
+        const std::string_view strings = sectionData(Section::Strings);
+
+        const std::string_view angles = sectionData(Section::Angles);
+        if (angles.size() < 2 * sizeof(double))
+            throw LevelBinaryException("a level must have at least two tiles");
+        tiles.reserve(angles.size() / sizeof(double));
+        for (size_t i = 0; i < angles.size(); i += sizeof(double))
+        {
+            double angle;
+            std::memcpy(&angle, angles.data() + i, sizeof(angle));
+            tiles.emplace_back(angle);
+        }
+
+        const std::string_view settingsData = sectionData(Section::Settings);
+        Reader settingsReader(settingsData.data(), settingsData.data() + settingsData.size(), strings);
+        transferSettings(settingsReader, settings);
+
+        const std::string_view events = sectionData(Section::Events);
+        Reader eventsReader(events.data(), events.data() + events.size(), strings);
+        uint64_t count;
+        eventsReader(count);
+        const char* cur = events.data() + sizeof(count);
+        for (uint64_t i = 0; i < count; i++)
+        {
+            uint16_t tag, zero;
+            uint32_t payloadSize;
+            Reader recordReader(cur, events.data() + events.size(), strings);
+            recordReader(tag), recordReader(zero), recordReader(payloadSize);
+            cur += sizeof(tag) + sizeof(zero) + sizeof(payloadSize);
+            if (payloadSize > static_cast<size_t>(events.data() + events.size() - cur))
+                throw LevelBinaryException("truncated record");
+            Reader payloadReader(cur, cur + payloadSize, strings);
+            cur += payloadSize;
+            // Records of tags this version does not know are skipped.
+            auto event = std::shared_ptr<Event::Event>(readEvent(tag, payloadReader));
+            if (!event)
+                continue;
+            if (event->floor >= tiles.size())
+                throw LevelBinaryException("event floor out of range");
+            tiles[event->floor].events.push_back(std::move(event));
+        }
+
+        decorations = sectionData(Section::Decorations);
+
+        if (header->flags & HasParseResults)
+            restoreParseResults(sectionData(Section::TileResults), sectionData(Section::TempoMap),
+                                sectionData(Section::MoveTracks), header->flags);
+    }
+    void Level::restoreParseResults(const std::string_view tileResults, const std::string_view tempoMap,
+                                    const std::string_view moveTracks, const uint32_t flags)
+    {
+        if (tileResults.size() != tiles.size() * sizeof(TileRecord) || tempoMap.empty())
+            throw LevelBinaryException("incomplete parse results");
+        const bool animations = flags & HasTrackAnimations;
+        for (size_t i = 0; i < tiles.size(); i++)
+        {
+            TileRecord r;
+            std::memcpy(&r, tileResults.data() + i * sizeof(r), sizeof(r));
+            if (r.trackAnimationFloor >= tiles.size())
+                throw LevelBinaryException("tile out of range");
+            if (r.stickToFloors > 1)
+                throw LevelBinaryException("invalid boolean");
+            // clang-format off
+            auto& tile = tiles[i];
+            tile.orbit                    = checkedEnum<Orbit>(r.orbit);
+            tile.beat                     = r.beat,                tile.seconds = r.seconds;
+            tile.stickToFloors            = r.stickToFloors;
+            tile.editorPos                = {r.editorX, r.editorY};
+            tile.pos.o                    = {r.posX, r.posY};
+            tile.rotation.o               = r.rotation;
+            tile.scale.o                  = {r.scaleX, r.scaleY};
+
+            tile.trackColorType.o         = checkedEnum<TrackColorType>(r.trackColorType);
+            tile.trackColor.o             = fromRgba(r.trackColor);
+            tile.secondaryTrackColor.o    = fromRgba(r.secondaryTrackColor);
+            tile.trackColorAnimDuration.o = r.trackColorAnimDuration;
+            tile.trackStyle.o             = checkedEnum<TrackStyle>(r.trackStyle);
+            tile.trackColorPulse.o        = checkedEnum<TrackColorPulse>(r.trackColorPulse);
+            tile.trackPulseLength.o       = r.trackPulseLength;
+
+            tile.trackAnimationFloor      = r.trackAnimationFloor;
+            tile.trackAnimation           = checkedEnum<TrackAnimation>(r.trackAnimation);
+            tile.beatsAhead               = r.beatsAhead;
+            tile.trackDisappearAnimation  = checkedEnum<TrackDisappearAnimation>(r.trackDisappearAnimation);
+            tile.beatsBehind              = r.beatsBehind;
+            if (animations)
+                tile.appearSeconds        = r.appearSeconds,       tile.disappearSeconds = r.disappearSeconds,
+                tile.animationDuration    = r.animationDuration;
+
+            tile.hitsound                 = checkedEnum<Hitsound>(r.hitsound);
+            tile.hitsoundVolume           = r.hitsoundVolume;
+            tile.midspinHitsound          = checkedEnum<Hitsound>(r.midspinHitsound);
+            tile.midspinHitsoundVolume    = r.midspinHitsoundVolume;
+            // clang-format on
+        }
+
+        m_tempoSegments.resize(tempoMap.size() / sizeof(TempoRecord));
+        for (size_t i = 0; i < m_tempoSegments.size(); i++)
+        {
+            TempoRecord r;
+            std::memcpy(&r, tempoMap.data() + i * sizeof(r), sizeof(r));
+            if (r.floor >= tiles.size())
+                throw LevelBinaryException("tile out of range");
+            m_tempoSegments[i] = {r.floor, r.angleOffset, r.beat, r.seconds, r.bpm};
+        }
+
+        // Like parse(), the level counts as parsed while the events are resolved.
+        parsed = true, onlyBasic = false;
+
+        // The first tile is stored as parse() leaves it, but the events are resolved against its countdown.
+        std::tie(tiles[0].beat, tiles[0].seconds) = firstTileTime();
+
+        // The SetSpeeds start the tempo segments after the first one.
+        collectSetSpeeds();
+        if (m_setSpeeds.size() + 1 != m_tempoSegments.size())
+            throw LevelBinaryException("the tempo map does not match the events");
+        for (size_t i = 0; i < m_setSpeeds.size(); i++)
+            m_setSpeeds[i]->seconds = m_tempoSegments[i + 1].seconds;
+
+        if (!m_disableAnimateTrack && !animations)
+            parseAnimateTrack();
+        resolveDynamicEvents();
+
+        if (m_streamingWindow > 0)
+            parseStreamingSource();
+        else if (flags & HasMoveTracks)
+        {
+            for (size_t i = 0; i < moveTracks.size() / sizeof(MoveTrackRecord); i++)
+            {
+                MoveTrackRecord r;
+                std::memcpy(&r, moveTracks.data() + i * sizeof(r), sizeof(r));
+                if (r.tile >= tiles.size() || r.floor >= tiles.size())
+                    throw LevelBinaryException("tile out of range");
+                const auto get = [&r](const double value, const uint32_t bit)
+                { return r.present & bit ? std::optional(value) : std::nullopt; };
+                // clang-format off
+                tiles[r.tile].moveTrackDatas.emplace_back(
+                    r.floor, r.angleOffset, r.beat, r.seconds,
+                    RelativeIndex(r.startIndex, checkedEnum<RelativeToTile>(r.startRelativeTo)),
+                    RelativeIndex(r.endIndex, checkedEnum<RelativeToTile>(r.endRelativeTo)),
+                    r.duration,
+                    OptionalPoint(get(r.positionX, MoveTrackRecord::PositionX),
+                                  get(r.positionY, MoveTrackRecord::PositionY)), r.xEndSec, r.yEndSec,
+                    get(r.rotationOffset, MoveTrackRecord::Rotation), r.rotEndSec,
+                    OptionalPoint(get(r.scaleX, MoveTrackRecord::ScaleX),
+                                  get(r.scaleY, MoveTrackRecord::ScaleY)), r.scXEndSec, r.scYEndSec,
+                    get(r.opacity, MoveTrackRecord::Opacity), r.opEndSec,
+                    checkedEnum<Easing>(r.ease));
+                // clang-format on
+            }
+        }
+        else
+            parseMoveTrackData();
+
+        tiles[0].beat = tiles[0].seconds = -std::numeric_limits<double>::infinity();
+    }
+    std::vector<char> Level::intoBinary(const bool parseResults) const
+    {
+        std::vector<char> data(sizeof(Header)), strings;
+        Header header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = formatVersion;
+        header.byteOrder = byteOrderMark;
+        const auto beginSection = [&data, &header](const Section section)
+        {
+            align(data);
+            header.sections[static_cast<size_t>(section)].offset = data.size();
+        };
+        const auto endSection = [&data, &header](const Section section)
+        {
+            auto& entry = header.sections[static_cast<size_t>(section)];
+            entry.size = data.size() - entry.offset;
+        };
+        const auto appendSection = [&](const Section section, const void* bytes, const size_t size)
+        {
+            beginSection(section);
+            data.insert(data.end(), static_cast<const char*>(bytes), static_cast<const char*>(bytes) + size);
+            endSection(section);
+        };
+
+        Writer writer(data, strings);
+
+        beginSection(Section::Angles);
+        for (const auto& tile : tiles)
+            writer(tile.angle.deg());
+        endSection(Section::Angles);
+
+        beginSection(Section::Settings);
+        transferSettings(writer, settings);
+        endSection(Section::Settings);
+
+        beginSection(Section::Events);
+        const size_t countOffset = data.size();
+        uint64_t count = 0;
+        writer(count);
+        for (const auto& tile : tiles)
+        {
+            for (const auto& tileEvent : tile.events)
+            {
+                // Deferred events are stored decoded (and skipped if they are invalid).
+                std::unique_ptr<Event::Event> decoded;
+                const Event::Event* event = tileEvent.get();
+                if (const auto deferred = dynamic_cast<const Event::Deferred*>(event))
+                {
+                    std::string error;
+                    decoded.reset(deferred->decode(error));
+                    if (!decoded)
+                        continue;
+                    event = decoded.get();
+                }
+                // Unknown events are stored under their own tag, whatever their eventType.
+                const auto tag = dynamic_cast<const Event::Unknown*>(event)
+                    ? eventTagNames.find("Unknown")
+                    : eventTagNames.find(event->name());
+                if (!tag)
+                    continue;
+                writer(static_cast<uint16_t>(*tag)), writer(static_cast<uint16_t>(0));
+                const size_t sizeOffset = data.size();
+                writer(static_cast<uint32_t>(0));
+                writeEvent(*tag, *event, writer);
+                const auto payloadSize = static_cast<uint32_t>(data.size() - sizeOffset - sizeof(uint32_t));
+                std::memcpy(data.data() + sizeOffset, &payloadSize, sizeof(payloadSize));
+                count++;
+            }
+        }
+        std::memcpy(data.data() + countOffset, &count, sizeof(count));
+        endSection(Section::Events);
+
+        appendSection(Section::Decorations, decorations.data(), decorations.size());
+
+        if (parseResults && parsed && !onlyBasic)
+        {
+            header.flags |= HasParseResults;
+            if (!m_disableAnimateTrack)
+                header.flags |= HasTrackAnimations;
+            // In streaming mode the tiles only hold the data of the current window.
+            if (m_streamingWindow == 0)
+                header.flags |= HasMoveTracks;
+
+            std::vector<TileRecord> tileRecords(tiles.size());
+            std::vector<MoveTrackRecord> moveTrackRecords;
+            for (size_t i = 0; i < tiles.size(); i++)
+            {
+                const auto& tile = tiles[i];
+                auto& record = tileRecords[i];
+                record.beat = tile.beat, record.seconds = tile.seconds;
+                record.editorX = tile.editorPos.x, record.editorY = tile.editorPos.y;
+                record.posX = tile.pos.o.x, record.posY = tile.pos.o.y;
+                record.rotation = tile.rotation.o;
+                record.scaleX = tile.scale.o.x, record.scaleY = tile.scale.o.y;
+                record.trackColorType = static_cast<uint8_t>(tile.trackColorType.o);
+                toRgba(tile.trackColor.o, record.trackColor);
+                toRgba(tile.secondaryTrackColor.o, record.secondaryTrackColor);
+                record.trackColorAnimDuration = tile.trackColorAnimDuration.o;
+                record.trackStyle = static_cast<uint8_t>(tile.trackStyle.o);
+                record.trackColorPulse = static_cast<int8_t>(tile.trackColorPulse.o);
+                record.trackPulseLength = tile.trackPulseLength.o;
+                record.trackAnimationFloor = tile.trackAnimationFloor;
+                record.trackAnimation = static_cast<uint8_t>(tile.trackAnimation);
+                record.beatsAhead = tile.beatsAhead;
+                record.trackDisappearAnimation = static_cast<uint8_t>(tile.trackDisappearAnimation);
+                record.beatsBehind = tile.beatsBehind;
+                record.appearSeconds = tile.appearSeconds, record.disappearSeconds = tile.disappearSeconds;
+                record.animationDuration = tile.animationDuration;
+                record.hitsound = static_cast<uint8_t>(tile.hitsound);
+                record.hitsoundVolume = tile.hitsoundVolume;
+                record.midspinHitsound = static_cast<uint8_t>(tile.midspinHitsound);
+                record.midspinHitsoundVolume = tile.midspinHitsoundVolume;
+                record.orbit = static_cast<uint8_t>(tile.orbit);
+                record.stickToFloors = tile.stickToFloors;
+
+                if (!(header.flags & HasMoveTracks))
+                    continue;
+                for (const auto& moveTrack : tile.moveTrackDatas)
+                {
+                    auto& r = moveTrackRecords.emplace_back();
+                    r.tile = i, r.floor = moveTrack.floor, r.angleOffset = moveTrack.angleOffset;
+                    r.beat = moveTrack.beat, r.seconds = moveTrack.seconds;
+                    r.startIndex = moveTrack.startTile.index, r.endIndex = moveTrack.endTile.index;
+                    r.startRelativeTo = moveTrack.startTile.relativeTo;
+                    r.endRelativeTo = moveTrack.endTile.relativeTo;
+                    r.duration = moveTrack.duration;
+                    r.xEndSec = moveTrack.xEndSec, r.yEndSec = moveTrack.yEndSec, r.rotEndSec = moveTrack.rotEndSec;
+                    r.scXEndSec = moveTrack.scXEndSec, r.scYEndSec = moveTrack.scYEndSec;
+                    r.opEndSec = moveTrack.opEndSec;
+                    r.ease = static_cast<uint32_t>(moveTrack.ease);
+                    const auto set = [&r](const auto& optional, double& field, const uint32_t bit)
+                    {
+                        if (optional)
+                            field = *optional, r.present |= bit;
+                    };
+                    set(moveTrack.positionOffset.first, r.positionX, MoveTrackRecord::PositionX);
+                    set(moveTrack.positionOffset.second, r.positionY, MoveTrackRecord::PositionY);
+                    set(moveTrack.rotationOffset, r.rotationOffset, MoveTrackRecord::Rotation);
+                    set(moveTrack.scale.first, r.scaleX, MoveTrackRecord::ScaleX);
+                    set(moveTrack.scale.second, r.scaleY, MoveTrackRecord::ScaleY);
+                    set(moveTrack.opacity, r.opacity, MoveTrackRecord::Opacity);
+                }
+            }
+            std::vector<TempoRecord> tempoRecords;
+            tempoRecords.reserve(m_tempoSegments.size());
+            for (const auto& [floor, angleOffset, beat, seconds, bpm] : m_tempoSegments)
+                tempoRecords.push_back({floor, angleOffset, beat, seconds, bpm});
+
+            appendSection(Section::TileResults, tileRecords.data(), tileRecords.size() * sizeof(TileRecord));
+            appendSection(Section::TempoMap, tempoRecords.data(), tempoRecords.size() * sizeof(TempoRecord));
+            appendSection(Section::MoveTracks, moveTrackRecords.data(),
+                          moveTrackRecords.size() * sizeof(MoveTrackRecord));
+        }
+
+        appendSection(Section::Strings, strings.data(), strings.size());
+        align(data);
+        header.fileSize = data.size();
+        std::memcpy(data.data(), &header, sizeof(header));
+        return data;
+    }
+    void Level::intoBinary(const std::filesystem::path& path, const bool parseResults) const
+    {
+        const auto data = intoBinary(parseResults);
+        std::ofstream ofs(path, std::ios::binary);
+        if (!ofs.is_open())
+            throw LevelCouldNotOpenFileException();
+        ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    bool Level::loadCache(const std::filesystem::path& path)
+    {
+        MappedFile file;
+        if (!file.open(path) || !readHeader(file.data(), file.size()))
+            return false;
+        try
+        {
+            fromBinary(file.data(), file.size());
+            // The modification time orders the eviction (see storeCache()).
+            std::error_code ec;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+            return true;
+        }
+        catch (const LevelBinaryException&)
+        {
+            clear();
+            return false;
+        }
+    }
+    void Level::storeCache(const std::filesystem::path& path)
+    {
+        // Stored with the parse results, so a cache hit skips parse() too.
+        parse();
+        // Written next to its final name and renamed, so a reader never sees a partial file.
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        auto temp = path;
+        temp += ".tmp";
+        try
+        {
+            intoBinary(temp, true);
+        }
+        catch (const LevelCouldNotOpenFileException&)
+        {
+            return;
+        }
+        std::filesystem::rename(temp, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(temp, ec);
+            return;
+        }
+        if (m_cacheSizeLimit == 0)
+            return;
+
+        struct CacheFile
+        {
+            std::filesystem::file_time_type time;
+            uintmax_t size;
+            std::filesystem::path path;
+        };
+        std::vector<CacheFile> files;
+        uintmax_t total = 0;
+        for (std::filesystem::directory_iterator it(path.parent_path(), ec), end; !ec && it != end; it.increment(ec))
+        {
+            if (it->path().extension() != ".adocache")
+                continue;
+            std::error_code fileEc;
+            const auto size = it->file_size(fileEc);
+            const auto time = it->last_write_time(fileEc);
+            if (fileEc)
+                continue;
+            files.push_back({time, size, it->path()});
+            total += size;
+        }
+        std::ranges::sort(files, {}, &CacheFile::time);
+        for (const auto& file : files)
+        {
+            if (total <= m_cacheSizeLimit)
+                break;
+            if (file.path != path && std::filesystem::remove(file.path, ec))
+                total -= file.size;
+        }
+    }
+} // namespace AdoCpp
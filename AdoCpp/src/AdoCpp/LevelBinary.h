@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "MappedFile.h"
+
+namespace AdoCpp::Binary
+{
+    /**
+     * @brief The first bytes of a compiled level.
+     */
+    constexpr char magic[8] = {'A', 'D', 'O', 'C', 'P', 'P', 'L', 'V'};
+    /**
+     * @brief The version of the compiled level format. Files of another version are rejected.
+     */
+    constexpr uint32_t formatVersion = 3;
+    /**
+     * @brief Written as is, so a file compiled on a machine of the other byte order is rejected.
+     */
+    constexpr uint32_t byteOrderMark = 0x01020304;
+
+    enum class Section : uint32_t
+    {
+        Strings,     ///< The bytes of every string, referenced by StringRef.
+        Angles,      ///< One double per tile: the angle in degrees.
+        Settings,    ///< The encoded settings.
+        Events,      ///< uint64 count, then per event: uint16 tag, uint16 0, uint32 payload size, payload.
+        TileResults, ///< One TileRecord per tile (parse results).
+        TempoMap,    ///< The TempoRecords (parse results).
+        MoveTracks,  ///< The MoveTrackRecords (parse results).
+        Decorations, ///< The decorations array as compact json.
+        Count
+    };
+
+    enum Flags : uint32_t
+    {
+        HasParseResults = 1 << 0,
+        HasTrackAnimations = 1 << 1, ///< The animation timing of the TileRecords is resolved.
+        HasMoveTracks = 1 << 2,      ///< The MoveTracks section holds every MoveTrack (not written in streaming mode).
+    };
+
+    struct SectionEntry
+    {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t flags;
+        uint32_t reserved;
+        uint64_t fileSize;
+        SectionEntry sections[static_cast<size_t>(Section::Count)];
+    };
+
+    /**
+     * @brief A string in the Strings section.
+     */
+    struct StringRef
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    /**
+     * @brief The parse results of a tile. The enumerations are stored as their values, the colors as RGBA.
+     */
+    struct TileRecord
+    {
+        double beat;
+        double seconds;
+        double editorX, editorY;
+        double posX, posY;
+        double rotation;
+        double scaleX, scaleY;
+        double trackColorAnimDuration;
+        double beatsAhead, beatsBehind;
+        double appearSeconds;
+        double disappearSeconds;
+        double animationDuration;
+        double hitsoundVolume, midspinHitsoundVolume;
+        uint64_t trackAnimationFloor;
+        uint8_t trackColor[4], secondaryTrackColor[4];
+        uint32_t trackPulseLength;
+        int8_t trackColorPulse;
+        uint8_t trackColorType, trackStyle;
+        uint8_t trackAnimation, trackDisappearAnimation;
+        uint8_t hitsound, midspinHitsound;
+        uint8_t orbit;
+        uint8_t stickToFloors;
+        uint8_t reserved[3];
+    };
+
+    /**
+     * @brief A span of constant bpm (see Level's tempo map).
+     */
+    struct TempoRecord
+    {
+        uint64_t floor;
+        double angleOffset;
+        double beat;
+        double seconds;
+        double bpm;
+    };
+
+    /**
+     * @brief A resolved MoveTrack on a tile. Absent optional values are flagged in present.
+     */
+    struct MoveTrackRecord
+    {
+        enum Present : uint32_t
+        {
+            PositionX = 1 << 0,
+            PositionY = 1 << 1,
+            Rotation = 1 << 2,
+            ScaleX = 1 << 3,
+            ScaleY = 1 << 4,
+            Opacity = 1 << 5,
+        };
+        uint64_t tile;
+        uint64_t floor;
+        double angleOffset;
+        double beat;
+        double seconds;
+        int64_t startIndex;
+        int64_t endIndex;
+        uint32_t startRelativeTo;
+        uint32_t endRelativeTo;
+        double duration;
+        double positionX, positionY;
+        double xEndSec, yEndSec;
+        double rotationOffset;
+        double rotEndSec;
+        double scaleX, scaleY;
+        double scXEndSec, scYEndSec;
+        double opacity;
+        double opEndSec;
+        uint32_t ease;
+        uint32_t present;
+    };
+
+    /**
+     * @brief Hash some bytes (64-bit FNV-1a).
+     */
+    [[nodiscard]] uint64_t contentHash(const char* data, size_t size, uint64_t seed = 0) noexcept;
+    /**
+     * @brief Get the name of the cache file of a level file.
+     * @param data The contents of the level file.
+     * @param size The number of bytes.
+     * @return The name, made of the hash of the contents and the format version.
+     */
+    [[nodiscard]] std::string cacheFileName(const char* data, size_t size);
+
+    /**
+     * @brief Read and validate the header of a compiled level.
+     * @param data The bytes of the file (no alignment is required).
+     * @param size The number of bytes.
+     * @return The header, or std::nullopt if the data is not a compiled level of this version.
+     */
+    [[nodiscard]] std::optional<Header> readHeader(const char* data, size_t size) noexcept;
+
+    /**
+     * A compiled level is used in place: the sections are only validated and turned into pointers into the
+     * mapping, nothing is decoded. Use Level::fromBinary to get a Level.
+     * @brief A read-only view of a compiled level file.
+     */
+    class CompiledLevel
+    {
+    public:
+        CompiledLevel() = default;
+        /**
+         * @brief Map and validate a compiled level.
+         * @param path The path to the file.
+         */
+        explicit CompiledLevel(const std::filesystem::path& path);
+
+        /**
+         * @brief Map and validate a compiled level.
+         * @param path The path to the file.
+         * @return Whether the file could be opened and is a compiled level of this version.
+         */
+        bool open(const std::filesystem::path& path);
+
+        [[nodiscard]] bool isOpen() const noexcept;
+        [[nodiscard]] const char* data() const noexcept;
+        [[nodiscard]] size_t size() const noexcept;
+        [[nodiscard]] bool hasParseResults() const noexcept;
+
+        /**
+         * @brief Get the number of tiles.
+         */
+        [[nodiscard]] size_t tileCount() const noexcept;
+        /**
+         * @brief Get the number of events.
+         */
+        [[nodiscard]] size_t eventCount() const noexcept;
+        /**
+         * @brief Get the angles of the tiles in degrees.
+         */
+        [[nodiscard]] std::span<const double> angles() const noexcept;
+        /**
+         * @brief Get the parse results of the tiles (empty without parse results).
+         */
+        [[nodiscard]] std::span<const TileRecord> tileResults() const noexcept;
+        /**
+         * @brief Get the tempo map (empty without parse results).
+         */
+        [[nodiscard]] std::span<const TempoRecord> tempoMap() const noexcept;
+        /**
+         * @brief Get the resolved MoveTracks (empty without parse results).
+         */
+        [[nodiscard]] std::span<const MoveTrackRecord> moveTracks() const noexcept;
+        /**
+         * @brief Get a string of the Strings section.
+         */
+        [[nodiscard]] std::string_view string(StringRef ref) const noexcept;
+
+    private:
+        template <typename T>
+        [[nodiscard]] std::span<const T> section(Section section) const noexcept;
+
+        MappedFile m_file;
+        std::optional<Header> m_header;
+    };
+} // namespace AdoCpp::Binary
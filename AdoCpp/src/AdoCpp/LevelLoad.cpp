@@ -0,0 +1,129 @@
+#include "LevelLoad.h"
+
+#include <condition_variable>
+
+#include "Level.h"
+#include "ThreadPool.h"
+
+namespace AdoCpp
+{
+    void LoadProgress::enter(const LoadStage next)
+    {
+        if (cancelled.load(std::memory_order_relaxed))
+            throw LevelLoadCancelledException();
+        stageProgress.store(0, std::memory_order_relaxed);
+        stage.store(next, std::memory_order_release);
+    }
+    float LoadProgress::progress() const noexcept
+    {
+        // Read, Json, Events, Parse
+        constexpr float weights[] = {0.05f, 0.6f, 0.1f, 0.25f};
+        const auto current = static_cast<size_t>(stage.load(std::memory_order_acquire));
+        if (current >= std::size(weights))
+            return 1;
+        float sum = 0;
+        for (size_t i = 0; i < current; i++)
+            sum += weights[i];
+        return sum + weights[current] * stageProgress.load(std::memory_order_relaxed);
+    }
+    void LoadProgress::preview(std::vector<double> angles)
+    {
+        std::lock_guard lock(m_previewMutex);
+        m_preview = std::move(angles);
+    }
+    std::vector<double> LoadProgress::preview() const
+    {
+        std::lock_guard lock(m_previewMutex);
+        return m_preview;
+    }
+
+    struct LevelLoad::State : LoadProgress
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done = false;
+        std::exception_ptr error;
+        LoadDiagnostics diagnostics;
+
+        void finish()
+        {
+            {
+                std::lock_guard lock(mutex);
+                done = true;
+            }
+            cv.notify_all();
+        }
+    };
+
+    LevelLoad& LevelLoad::operator=(LevelLoad&& other) noexcept
+    {
+        if (this != &other)
+        {
+            cancel();
+            if (m_state)
+                wait();
+            m_state = std::move(other.m_state);
+        }
+        return *this;
+    }
+    LevelLoad::~LevelLoad()
+    {
+        cancel();
+        if (m_state)
+            wait();
+    }
+    bool LevelLoad::valid() const noexcept { return m_state != nullptr; }
+    LoadStage LevelLoad::stage() const noexcept { return m_state->stage.load(std::memory_order_acquire); }
+    float LevelLoad::stageProgress() const noexcept { return m_state->stageProgress.load(std::memory_order_relaxed); }
+    float LevelLoad::progress() const noexcept { return m_state->progress(); }
+    std::vector<double> LevelLoad::preview() const { return m_state->preview(); }
+    bool LevelLoad::ready() const
+    {
+        std::lock_guard lock(m_state->mutex);
+        return m_state->done;
+    }
+    void LevelLoad::wait() const
+    {
+        std::unique_lock lock(m_state->mutex);
+        m_state->cv.wait(lock, [this] { return m_state->done; });
+    }
+    void LevelLoad::cancel() noexcept
+    {
+        if (m_state)
+            m_state->cancelled.store(true, std::memory_order_relaxed);
+    }
+    void LevelLoad::get() const
+    {
+        wait();
+        if (m_state->error)
+            std::rethrow_exception(m_state->error);
+    }
+    const LoadDiagnostics& LevelLoad::diagnostics() const { return m_state->diagnostics; }
+
+    LevelLoad Level::loadAsync(const std::filesystem::path& path, ThreadPool& executor)
+    {
+        auto state = std::make_shared<LevelLoad::State>();
+        executor.submit(
+            [this, path, state]
+            {
+                try
+                {
+                    load(path, state->diagnostics, state.get());
+                    // The events of the actions have been built while reading the json, but not the deferred ones.
+                    state->enter(LoadStage::Events);
+                    if (m_hasDeferredEvents)
+                        decodeEvents(state->diagnostics);
+                    state->enter(LoadStage::Parse);
+                    parse();
+                    state->enter(LoadStage::Done);
+                }
+                catch (...)
+                {
+                    clear();
+                    state->error = std::current_exception();
+                }
+                state->finish();
+            });
+        return LevelLoad(std::move(state));
+    }
+} // namespace AdoCpp
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace AdoCpp
+{
+    struct LoadDiagnostics;
+
+    /**
+     * @brief The stages of an asynchronous load (see Level::loadAsync()), in order.
+     */
+    enum class LoadStage
+    {
+        Read,   //!< Opening the file (or its cached copy).
+        Json,   //!< Reading the json into tiles, settings and events.
+        Events, //!< Placing the events on their tiles and decoding the deferred ones.
+        Parse,  //!< Parsing the level.
+        Done
+    };
+    constexpr const char* const cstrLoadStage[] = {"Reading", "Reading json", "Building events", "Parsing", "Done"};
+    constexpr const char* loadStage2cstr(const LoadStage& stage) { return cstrLoadStage[static_cast<int>(stage)]; }
+
+    class LevelLoadCancelledException final : public std::exception
+    {
+    public:
+        LevelLoadCancelledException() = default;
+        [[nodiscard]] const char* what() const noexcept override
+        {
+            return "LevelLoadCancelledException: the load has been cancelled";
+        }
+    };
+
+    /**
+     * The loading thread writes it while any other thread may read it or cancel the load.
+     * @brief The progress of a load.
+     */
+    struct LoadProgress
+    {
+        /**
+         * @brief The number of tiles (after the first one) kept for preview().
+         */
+        static constexpr size_t previewTileCount = 512;
+
+        std::atomic<LoadStage> stage = LoadStage::Read;
+        /**
+         * @brief The progress in the current stage, from 0 to 1.
+         */
+        std::atomic<float> stageProgress = 0;
+        std::atomic<bool> cancelled = false;
+
+        /**
+         * @brief Enter the next stage.
+         * @throw LevelLoadCancelledException If the load has been cancelled.
+         */
+        void enter(LoadStage next);
+        /**
+         * @brief Get the overall progress, from 0 to 1 (the stages are weighted by their usual share of the time).
+         */
+        [[nodiscard]] float progress() const noexcept;
+        /**
+         * @brief Keep the angles of the first tiles once they are known.
+         */
+        void preview(std::vector<double> angles);
+        /**
+         * @brief Get the angles of the first tiles (empty until they are known).
+         */
+        [[nodiscard]] std::vector<double> preview() const;
+
+    private:
+        mutable std::mutex m_previewMutex;
+        std::vector<double> m_preview;
+    };
+
+    /**
+     * Destroying (or reassigning) a handle that is still loading cancels the load and waits for it,
+     * so the level is never written after its handle is gone.
+     * @brief The handle of an asynchronous load (see Level::loadAsync()).
+     */
+    class LevelLoad
+    {
+    public:
+        LevelLoad() = default;
+        LevelLoad(LevelLoad&&) noexcept = default;
+        LevelLoad& operator=(LevelLoad&& other) noexcept;
+        ~LevelLoad();
+
+        /**
+         * @brief Get whether the handle refers to a load.
+         */
+        [[nodiscard]] bool valid() const noexcept;
+        [[nodiscard]] LoadStage stage() const noexcept;
+        /**
+         * @brief Get the progress in the current stage, from 0 to 1.
+         */
+        [[nodiscard]] float stageProgress() const noexcept;
+        /**
+         * @brief Get the overall progress, from 0 to 1.
+         */
+        [[nodiscard]] float progress() const noexcept;
+        /**
+         * The angles (in degrees) of up to LoadProgress::previewTileCount tiles after the first one are available
+         * as soon as angleData or pathData has been read, long before the load is done, so that they can be shown
+         * in the meantime.
+         * @brief Get the angles of the first tiles (empty until they are known).
+         */
+        [[nodiscard]] std::vector<double> preview() const;
+
+        /**
+         * @brief Get whether the load has finished (successfully or not).
+         */
+        [[nodiscard]] bool ready() const;
+        /**
+         * @brief Wait until the load has finished.
+         */
+        void wait() const;
+        /**
+         * The load stops at the next check (between two batches of json or two stages), clears the level,
+         * and get() throws LevelLoadCancelledException.
+         * @brief Ask the load to stop.
+         */
+        void cancel() noexcept;
+        /**
+         * @brief Wait until the load has finished and rethrow what it threw, if anything.
+         * @throw LevelLoadCancelledException If the load has been cancelled.
+         */
+        void get() const;
+        /**
+         * @brief Get the warnings of the load (complete once it has finished).
+         */
+        [[nodiscard]] const LoadDiagnostics& diagnostics() const;
+
+    private:
+        friend class Level;
+        struct State;
+        explicit LevelLoad(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+        std::shared_ptr<State> m_state;
+    };
+} // namespace AdoCpp
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <memory>
+#include <typeindex>
+
+#include "Event.h"
+#include "Level.h"
+
+namespace AdoCpp
+{
+    namespace
+    {
+        // The json of the event without its floor, to compare events on different floors.
+        std::string fieldsJson(const Event::Event& event)
+        {
+            const std::unique_ptr<Event::Event> copy(event.clone());
+            copy->floor = 0;
+            return compactJson(*copy->intoJson());
+        }
+    } // namespace
+
+    OptimizeStats Level::optimize()
+    {
+        if (m_hasDeferredEvents)
+            decodeEvents();
+        OptimizeStats stats;
+
+        // Inactive events are skipped by every pass of parse().
+        for (auto& tile : tiles)
+            stats.inactive += std::erase_if(tile.events, [](const auto& event) { return !event->active; });
+
+        // Only the last non-stackable event of each type on a floor takes effect (see parseTiles()). A floor may
+        // set both of its hitsounds, so SetHitsound only overrides the one with the same gameSound.
+        std::vector<std::pair<std::type_index, int>> seen;
+        for (auto& tile : tiles)
+        {
+            seen.clear();
+            for (auto it = tile.events.rbegin(); it != tile.events.rend();)
+            {
+                const Event::Event& event = **it;
+                if (event.stackable())
+                {
+                    ++it;
+                    continue;
+                }
+                const auto setHitsound = dynamic_cast<const Event::GamePlay::SetHitsound*>(&event);
+                const std::pair<std::type_index, int> type(typeid(event),
+                                                           setHitsound ? static_cast<int>(setHitsound->gameSound) : 0);
+                if (std::ranges::find(seen, type) == seen.end())
+                {
+                    seen.push_back(type);
+                    ++it;
+                    continue;
+                }
+                it = std::make_reverse_iterator(tile.events.erase(std::next(it).base()));
+                stats.overridden++;
+            }
+        }
+
+        // A ColorTrack that repeats the one in effect changes no tile.
+        std::string colorTrack;
+        for (auto& tile : tiles)
+        {
+            for (auto it = tile.events.begin(); it != tile.events.end();)
+            {
+                if (typeid(**it) != typeid(Event::Track::ColorTrack))
+                {
+                    ++it;
+                    continue;
+                }
+                if (std::string json = fieldsJson(**it); json != colorTrack)
+                {
+                    colorTrack = std::move(json);
+                    ++it;
+                    continue;
+                }
+                it = tile.events.erase(it);
+                stats.colorTracks++;
+            }
+        }
+
+        // A MoveTrack that sets nothing moves nothing (see updateTilePos()), however long it lasts.
+        for (auto& tile : tiles)
+        {
+            stats.moveTracks += std::erase_if(
+                tile.events,
+                [](const auto& event)
+                {
+                    const auto moveTrack = dynamic_cast<const Event::Track::MoveTrack*>(event.get());
+                    return moveTrack && !moveTrack->positionOffset.first && !moveTrack->positionOffset.second &&
+                        !moveTrack->rotationOffset && !moveTrack->scale.first && !moveTrack->scale.second &&
+                        !moveTrack->opacity;
+                });
+        }
+
+        // SetSpeeds in the order parseSetSpeed() applies them.
+        struct SpeedChange
+        {
+            size_t floor;
+            Event::GamePlay::SetSpeed* setSpeed;
+        };
+        std::vector<SpeedChange> changes;
+        for (size_t floor = 0; floor < tiles.size(); floor++)
+            for (const auto& event : tiles[floor].events)
+                if (const auto setSpeed = dynamic_cast<Event::GamePlay::SetSpeed*>(event.get()))
+                    changes.push_back({floor, setSpeed});
+        std::ranges::stable_sort(changes,
+                                 [](const SpeedChange& a, const SpeedChange& b)
+                                 {
+                                     return a.floor < b.floor ||
+                                         (a.floor == b.floor && a.setSpeed->angleOffset < b.setSpeed->angleOffset);
+                                 });
+        // A run of SetSpeeds at the same moment only leaves the last bpm, and the segments before it are empty,
+        // so it is replaced by its last SetSpeed giving that bpm. If the bpm does not change, the run is dropped.
+        std::vector<const Event::Event*> removed;
+        double bpm = settings.bpm;
+        for (size_t begin = 0, end; begin < changes.size(); begin = end)
+        {
+            double runBpm = bpm;
+            for (end = begin; end < changes.size() && changes[end].floor == changes[begin].floor &&
+                 changes[end].setSpeed->angleOffset == changes[begin].setSpeed->angleOffset;
+                 end++)
+            {
+                const auto& setSpeed = *changes[end].setSpeed;
+                runBpm = setSpeed.speedType == Event::GamePlay::SetSpeed::SpeedType::Bpm
+                    ? setSpeed.beatsPerMinute
+                    : runBpm * setSpeed.bpmMultiplier;
+            }
+            const size_t keep = runBpm == bpm ? end : end - 1;
+            for (size_t i = begin; i < keep; i++)
+                removed.push_back(changes[i].setSpeed);
+            if (keep != end && end - begin > 1 &&
+                changes[keep].setSpeed->speedType == Event::GamePlay::SetSpeed::SpeedType::Multiplier)
+            {
+                changes[keep].setSpeed->speedType = Event::GamePlay::SetSpeed::SpeedType::Bpm;
+                changes[keep].setSpeed->beatsPerMinute = runBpm;
+            }
+            bpm = runBpm;
+        }
+        std::ranges::sort(removed);
+        for (auto& tile : tiles)
+            stats.setSpeeds += std::erase_if(tile.events, [&removed](const auto& event)
+                                             { return std::ranges::binary_search(removed, event.get()); });
+
+        parsed = false;
+        return stats;
+    }
+} // namespace AdoCpp
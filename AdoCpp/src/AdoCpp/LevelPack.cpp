@@ -0,0 +1,173 @@
+#include "LevelPack.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "Level.h"
+#include "LevelBinary.h"
+
+namespace AdoCpp
+{
+    using namespace Pack;
+
+    namespace
+    {
+        bool inRange(const Blob& blob, const size_t size)
+        {
+            return blob.offset <= size && blob.size <= size - blob.offset;
+        }
+        void align(std::ofstream& ofs)
+        {
+            constexpr char zeros[8]{};
+            if (const auto rem = static_cast<size_t>(ofs.tellp()) % 8)
+                ofs.write(zeros, static_cast<std::streamsize>(8 - rem));
+        }
+    } // namespace
+
+    void LevelPackWriter::add(std::string name, const Level& level, const std::filesystem::path& audio)
+    {
+        m_entries.push_back({std::move(name), level.intoBinary(), audio});
+    }
+    void LevelPackWriter::add(std::string name, const std::filesystem::path& path, LoadDiagnostics& diagnostics)
+    {
+        Level level;
+        level.fromFile(path, diagnostics);
+        if (level.tiles.size() < 2)
+            throw LevelFormatException("a level must have at least two tiles");
+        level.parse();
+        std::filesystem::path audio;
+        if (!level.settings.songFilename.empty())
+            audio = path.parent_path() / level.settings.songFilename;
+        std::error_code ec;
+        add(std::move(name), level, std::filesystem::is_regular_file(audio, ec) ? audio : std::filesystem::path());
+    }
+    size_t LevelPackWriter::size() const noexcept { return m_entries.size(); }
+
+    void LevelPackWriter::write(const std::filesystem::path& path) const
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        if (!ofs.is_open())
+            throw LevelCouldNotOpenFileException();
+        Header header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = formatVersion;
+        header.byteOrder = Binary::byteOrderMark;
+        header.entryCount = m_entries.size();
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        // The blobs first, so the music files are copied straight into the pack.
+        std::vector<EntryRecord> records;
+        std::vector<char> strings;
+        records.reserve(m_entries.size());
+        const auto addString = [&strings](const std::string& str, uint32_t& offset, uint32_t& length)
+        {
+            offset = static_cast<uint32_t>(strings.size());
+            length = static_cast<uint32_t>(str.size());
+            strings.insert(strings.end(), str.begin(), str.end());
+        };
+        for (const auto& [name, level, audio] : m_entries)
+        {
+            EntryRecord record{};
+            addString(name, record.nameOffset, record.nameLength);
+            align(ofs);
+            record.level = {static_cast<uint64_t>(ofs.tellp()), level.size()};
+            ofs.write(level.data(), static_cast<std::streamsize>(level.size()));
+            if (!audio.empty())
+            {
+                std::ifstream ifs(audio, std::ios::binary);
+                if (!ifs.is_open())
+                    throw LevelCouldNotOpenFileException();
+                addString(audio.filename().string(), record.audioNameOffset, record.audioNameLength);
+                align(ofs);
+                record.audio.offset = static_cast<uint64_t>(ofs.tellp());
+                // An empty music file would set failbit on the pack.
+                if (ifs.peek() != std::ifstream::traits_type::eof())
+                    ofs << ifs.rdbuf();
+                record.audio.size = static_cast<uint64_t>(ofs.tellp()) - record.audio.offset;
+            }
+            records.push_back(record);
+        }
+
+        align(ofs);
+        header.index = {static_cast<uint64_t>(ofs.tellp()), records.size() * sizeof(EntryRecord)};
+        ofs.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(header.index.size));
+        header.strings = {static_cast<uint64_t>(ofs.tellp()), strings.size()};
+        ofs.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        header.fileSize = static_cast<uint64_t>(ofs.tellp());
+        ofs.seekp(0);
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!ofs)
+            throw LevelCouldNotOpenFileException();
+    }
+
+    LevelPack::LevelPack(const std::filesystem::path& path) { open(path); }
+    bool LevelPack::open(const std::filesystem::path& path)
+    {
+        close();
+        if (!m_file.open(path))
+            return false;
+        const char* data = m_file.data();
+        const size_t size = m_file.size();
+        Header header;
+        if (size < sizeof(Header))
+        {
+            close();
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != formatVersion ||
+            header.byteOrder != Binary::byteOrderMark || header.fileSize != size || !inRange(header.index, size) ||
+            !inRange(header.strings, size) || header.index.size / sizeof(EntryRecord) != header.entryCount ||
+            header.index.size % sizeof(EntryRecord) != 0)
+        {
+            close();
+            return false;
+        }
+
+        const std::string_view strings(data + header.strings.offset, header.strings.size);
+        const auto string = [&strings](const uint32_t offset, const uint32_t length) -> std::optional<std::string_view>
+        {
+            if (offset > strings.size() || length > strings.size() - offset)
+                return std::nullopt;
+            return strings.substr(offset, length);
+        };
+        m_entries.reserve(header.entryCount);
+        for (size_t i = 0; i < header.entryCount; i++)
+        {
+            EntryRecord record;
+            std::memcpy(&record, data + header.index.offset + i * sizeof(EntryRecord), sizeof(record));
+            const auto name = string(record.nameOffset, record.nameLength);
+            const auto audioName = string(record.audioNameOffset, record.audioNameLength);
+            if (!name || !audioName || !inRange(record.level, size) || !inRange(record.audio, size))
+            {
+                close();
+                return false;
+            }
+            m_entries.push_back({*name, *audioName, {data + record.level.offset, record.level.size},
+                                 {data + record.audio.offset, record.audio.size}});
+        }
+        return true;
+    }
+    void LevelPack::close() noexcept
+    {
+        m_entries.clear();
+        m_file.close();
+    }
+    bool LevelPack::isOpen() const noexcept { return m_file.isOpen(); }
+    size_t LevelPack::size() const noexcept { return m_entries.size(); }
+    const LevelPack::Entry& LevelPack::operator[](const size_t index) const noexcept { return m_entries[index]; }
+    std::vector<LevelPack::Entry>::const_iterator LevelPack::begin() const noexcept { return m_entries.begin(); }
+    std::vector<LevelPack::Entry>::const_iterator LevelPack::end() const noexcept { return m_entries.end(); }
+    std::optional<size_t> LevelPack::find(const std::string_view name) const noexcept
+    {
+        for (size_t i = 0; i < m_entries.size(); i++)
+            if (m_entries[i].name == name)
+                return i;
+        return std::nullopt;
+    }
+    void LevelPack::load(const size_t index, Level& level) const
+    {
+        const auto& entry = m_entries.at(index);
+        level.fromBinary(entry.level.data(), entry.level.size());
+    }
+} // namespace AdoCpp
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace AdoCpp
+{
+    class Level;
+    struct LoadDiagnostics;
+}
+
+namespace AdoCpp::Pack
+{
+    /**
+     * @brief The first bytes of a level pack.
+     */
+    constexpr char magic[8] = {'A', 'D', 'O', 'C', 'P', 'P', 'P', 'K'};
+    /**
+     * @brief The version of the level pack format. Files of another version are rejected.
+     */
+    constexpr uint32_t formatVersion = 1;
+
+    /**
+     * @brief A range of bytes of the pack.
+     */
+    struct Blob
+    {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder; ///< Binary::byteOrderMark
+        uint64_t fileSize;
+        uint64_t entryCount;
+        Blob index;   ///< entryCount EntryRecords.
+        Blob strings; ///< The bytes of the names, referenced by the EntryRecords.
+    };
+
+    /**
+     * The level is a compiled level (see LevelBinary.h) and the audio is a copy of the music file,
+     * both aligned to 8 bytes. An entry without music has an empty audio blob.
+     * @brief A level of the pack.
+     */
+    struct EntryRecord
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t audioNameOffset;
+        uint32_t audioNameLength;
+        Blob level;
+        Blob audio;
+    };
+} // namespace AdoCpp::Pack
+
+namespace AdoCpp
+{
+    /**
+     * A pack bundles several compiled levels with their music into one file:
+     * @code
+     * LevelPackWriter writer;
+     * writer.add("first", firstLevel, "first/song.ogg");
+     * writer.add("second", "second/level.adofai", diagnostics);
+     * writer.write("levels.adopack");
+     *
+     * LevelPack pack("levels.adopack");
+     * pack.load(*pack.find("second"), level);
+     * music.openFromMemory(pack[1].audio.data(), pack[1].audio.size());
+     * @endcode
+     * @brief Build a level pack.
+     */
+    class LevelPackWriter
+    {
+    public:
+        /**
+         * The level is compiled right away (with its parse results if it has been fully parsed, which
+         * LevelPack::load() restores), the music is read by write().
+         * @brief Add a level.
+         * @param name The name of the entry.
+         * @param level The level.
+         * @param audio The path to the music file (empty for none).
+         */
+        void add(std::string name, const Level& level, const std::filesystem::path& audio = {});
+        /**
+         * The music is the songFilename of the level, next to the level file (none if there is no such file).
+         * @brief Load, parse and add a level file.
+         * @param name The name of the entry.
+         * @param path The path to the level file.
+         * @param diagnostics Receives the warnings of the level.
+         * @throw LevelFormatException If the level has fewer than two tiles.
+         */
+        void add(std::string name, const std::filesystem::path& path, LoadDiagnostics& diagnostics);
+
+        /**
+         * @brief Get the number of levels added.
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * @brief Write the pack.
+         * @param path The path to the file.
+         * @throw LevelCouldNotOpenFileException If the pack or a music file cannot be opened.
+         */
+        void write(const std::filesystem::path& path) const;
+
+    private:
+        struct Entry
+        {
+            std::string name;
+            std::vector<char> level;
+            std::filesystem::path audio;
+        };
+        std::vector<Entry> m_entries;
+    };
+
+    /**
+     * The pack is memory-mapped and used in place: the compiled levels are only decoded by load() and the music
+     * is a view into the mapping (so it must outlive anything that streams from it, like an sf::Music).
+     * @brief A read-only view of a level pack.
+     */
+    class LevelPack
+    {
+    public:
+        /**
+         * @brief An entry of the pack. The views point into the mapping.
+         */
+        struct Entry
+        {
+            std::string_view name;
+            /**
+             * @brief The file name of the music, for its extension (empty without music).
+             */
+            std::string_view audioName;
+            std::span<const char> level;
+            std::span<const char> audio;
+        };
+
+        LevelPack() = default;
+        /**
+         * @brief Map and validate a level pack.
+         * @param path The path to the file.
+         */
+        explicit LevelPack(const std::filesystem::path& path);
+
+        /**
+         * @brief Map and validate a level pack, closing the previous one.
+         * @param path The path to the file.
+         * @return Whether the file could be opened and is a level pack of this version.
+         */
+        bool open(const std::filesystem::path& path);
+        /**
+         * @brief Unmap the pack.
+         */
+        void close() noexcept;
+
+        [[nodiscard]] bool isOpen() const noexcept;
+        /**
+         * @brief Get the number of levels.
+         */
+        [[nodiscard]] size_t size() const noexcept;
+        [[nodiscard]] const Entry& operator[](size_t index) const noexcept;
+        [[nodiscard]] std::vector<Entry>::const_iterator begin() const noexcept;
+        [[nodiscard]] std::vector<Entry>::const_iterator end() const noexcept;
+        /**
+         * @brief Find a level by name.
+         * @return The index of the level, or std::nullopt if there is none with this name.
+         */
+        [[nodiscard]] std::optional<size_t> find(std::string_view name) const noexcept;
+
+        /**
+         * The parse results of the level are restored as by Level::fromBinary(), so a level added by
+         * LevelPackWriter::add(name, path) is left parsed.
+         * @brief Import a level of the pack.
+         * @param index The index of the level.
+         * @param level The level to import into.
+         */
+        void load(size_t index, Level& level) const;
+
+    private:
+        MappedFile m_file;
+        std::vector<Entry> m_entries;
+    };
+} // namespace AdoCpp
@@ -0,0 +1,759 @@
+#include "LevelReader.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <rapidjson/memorystream.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+#include <string_view>
+
+#include "Level.h"
+
+namespace AdoCpp
+{
+    JsonValueBuilder::JsonValueBuilder() : m_alloc(m_buffer, sizeof(m_buffer)) {}
+
+    bool JsonValueBuilder::Null()
+    {
+        m_stack.emplace_back();
+        return true;
+    }
+    bool JsonValueBuilder::Bool(const bool b)
+    {
+        m_stack.emplace_back(b);
+        return true;
+    }
+    bool JsonValueBuilder::Int(const int i)
+    {
+        m_stack.emplace_back(i);
+        return true;
+    }
+    bool JsonValueBuilder::Uint(const unsigned u)
+    {
+        m_stack.emplace_back(u);
+        return true;
+    }
+    bool JsonValueBuilder::Int64(const int64_t i)
+    {
+        m_stack.emplace_back(i);
+        return true;
+    }
+    bool JsonValueBuilder::Uint64(const uint64_t u)
+    {
+        m_stack.emplace_back(u);
+        return true;
+    }
+    bool JsonValueBuilder::Double(const double d)
+    {
+        m_stack.emplace_back(d);
+        return true;
+    }
+    bool JsonValueBuilder::RawNumber(const char* str, const rapidjson::SizeType length, bool)
+    {
+        return parseNumber(*this, str, length);
+    }
+    bool JsonValueBuilder::String(const char* str, const rapidjson::SizeType length, const bool copy)
+    {
+        // Without copy the string lives in the (in-situ) source buffer.
+        if (copy)
+            m_stack.emplace_back(str, length, m_alloc);
+        else
+            m_stack.emplace_back(rapidjson::StringRef(str, length));
+        return true;
+    }
+    bool JsonValueBuilder::StartObject()
+    {
+        m_depth++;
+        return true;
+    }
+    bool JsonValueBuilder::Key(const char* str, const rapidjson::SizeType length, const bool copy)
+    {
+        return String(str, length, copy);
+    }
+    bool JsonValueBuilder::EndObject(const rapidjson::SizeType memberCount)
+    {
+        const size_t first = m_stack.size() - 2 * static_cast<size_t>(memberCount);
+        rapidjson::Value object(rapidjson::kObjectType);
+        for (size_t i = first; i < m_stack.size(); i += 2)
+            object.AddMember(m_stack[i], m_stack[i + 1], m_alloc);
+        m_stack.erase(m_stack.begin() + static_cast<std::ptrdiff_t>(first), m_stack.end());
+        m_stack.push_back(std::move(object));
+        m_depth--;
+        return true;
+    }
+    bool JsonValueBuilder::StartArray()
+    {
+        m_depth++;
+        return true;
+    }
+    bool JsonValueBuilder::EndArray(const rapidjson::SizeType elementCount)
+    {
+        const size_t first = m_stack.size() - elementCount;
+        rapidjson::Value array(rapidjson::kArrayType);
+        array.Reserve(elementCount, m_alloc);
+        for (size_t i = first; i < m_stack.size(); i++)
+            array.PushBack(m_stack[i], m_alloc);
+        m_stack.erase(m_stack.begin() + static_cast<std::ptrdiff_t>(first), m_stack.end());
+        m_stack.push_back(std::move(array));
+        m_depth--;
+        return true;
+    }
+    bool JsonValueBuilder::complete() const noexcept { return m_depth == 0 && !m_stack.empty(); }
+    bool JsonValueBuilder::idle() const noexcept { return m_depth == 0 && m_stack.empty(); }
+    rapidjson::Value& JsonValueBuilder::value()
+    {
+        assert(complete() && "AdoCpp::JsonValueBuilder has not read a whole value");
+        return m_stack.back();
+    }
+    std::span<rapidjson::Value> JsonValueBuilder::values()
+    {
+        assert(m_depth == 0 && "AdoCpp::JsonValueBuilder is in the middle of a value");
+        return m_stack;
+    }
+    void JsonValueBuilder::reset()
+    {
+        m_stack.clear();
+        m_depth = 0;
+        m_alloc.Clear(); // keeps the inline buffer
+    }
+
+    LevelReader::LevelReader(Level& level, LoadDiagnostics& diagnostics, LoadProgress* progress,
+                             const std::string_view json) :
+        m_level(level), m_diagnostics(diagnostics), m_progress(progress), m_json(json)
+    {
+        m_level.clear();
+        m_level.tiles.emplace_back(0);
+    }
+
+    bool LevelReader::Null()
+    {
+        return scalar([](JsonValueBuilder& b) { return b.Null(); });
+    }
+    bool LevelReader::Bool(const bool b)
+    {
+        return scalar([b](JsonValueBuilder& builder) { return builder.Bool(b); });
+    }
+    bool LevelReader::Int(const int i)
+    {
+        const double number = i;
+        return scalar([i](JsonValueBuilder& b) { return b.Int(i); }, &number);
+    }
+    bool LevelReader::Uint(const unsigned u)
+    {
+        const double number = u;
+        return scalar([u](JsonValueBuilder& b) { return b.Uint(u); }, &number);
+    }
+    bool LevelReader::Int64(const int64_t i)
+    {
+        const double number = static_cast<double>(i);
+        return scalar([i](JsonValueBuilder& b) { return b.Int64(i); }, &number);
+    }
+    bool LevelReader::Uint64(const uint64_t u)
+    {
+        const double number = static_cast<double>(u);
+        return scalar([u](JsonValueBuilder& b) { return b.Uint64(u); }, &number);
+    }
+    bool LevelReader::Double(const double d)
+    {
+        return scalar([d](JsonValueBuilder& b) { return b.Double(d); }, &d);
+    }
+    bool LevelReader::RawNumber(const char* str, const rapidjson::SizeType length, bool)
+    {
+        return tick(str) && parseNumber(*this, str, length);
+    }
+    bool LevelReader::String(const char* str, const rapidjson::SizeType length, const bool copy)
+    {
+        return scalar([=](JsonValueBuilder& b) { return b.String(str, length, copy); }, nullptr, str, length);
+    }
+    bool LevelReader::StartObject()
+    {
+        return open([](JsonValueBuilder& b) { return b.StartObject(); });
+    }
+    bool LevelReader::Key(const char* str, const rapidjson::SizeType length, const bool copy)
+    {
+        if (!tick(str))
+            return false;
+        if (m_section != Section::Root)
+        {
+            if (m_section == Section::Settings || m_section == Section::Decorations ||
+                (m_section == Section::Actions && m_depth > 2))
+                return m_builder.Key(str, length, copy);
+            return true;
+        }
+        if (m_depth != 1)
+            return true;
+
+        m_sectionOpen = false;
+        const std::string_view key(str, length);
+        if (key == "angleData")
+        {
+            m_section = Section::AngleData;
+            m_hasAngleData = true;
+            m_level.tiles.resize(1, Tile(0));
+        }
+        else if (key == "pathData")
+            m_section = Section::PathData;
+        else if (key == "settings")
+            m_section = Section::Settings;
+        else if (key == "actions")
+            m_section = Section::Actions;
+        else if (key == "decorations")
+            m_section = Section::Decorations;
+        else
+            m_section = Section::Skip;
+        return true;
+    }
+    bool LevelReader::EndObject(const rapidjson::SizeType memberCount)
+    {
+        return close([memberCount](JsonValueBuilder& b) { return b.EndObject(memberCount); });
+    }
+    bool LevelReader::StartArray()
+    {
+        m_depth++;
+        if ((m_section == Section::AngleData || m_section == Section::Actions) && !m_sectionOpen && m_depth == 2)
+        {
+            m_sectionOpen = true;
+            return true;
+        }
+        m_depth--;
+        return open([](JsonValueBuilder& b) { return b.StartArray(); });
+    }
+    bool LevelReader::EndArray(const rapidjson::SizeType elementCount)
+    {
+        return close([elementCount](JsonValueBuilder& b) { return b.EndArray(elementCount); });
+    }
+
+    template <typename Forward>
+    bool LevelReader::scalar(Forward forward, const double* number, const char* str, const size_t length)
+    {
+        switch (m_section)
+        {
+        case Section::Root:
+            return true;
+        case Section::Skip:
+            if (m_depth == 1)
+                m_section = Section::Root;
+            return true;
+        case Section::PathData:
+            if (str)
+            {
+                m_pathData.assign(str, length);
+                m_hasPathData = true;
+            }
+            m_section = Section::Root;
+            return true;
+        case Section::AngleData:
+            if (!m_sectionOpen)
+                m_section = Section::Root;
+            else if (m_depth == 2 && number)
+                m_level.tiles.emplace_back(*number);
+            else if (m_depth == 2)
+                m_diagnostics.warn(LoadDiagnostics::noAction, "angleData has an element that is not a number");
+            return true;
+        case Section::Actions:
+            if (!m_sectionOpen)
+            {
+                m_section = Section::Root;
+                return true;
+            }
+            [[fallthrough]];
+        case Section::Settings:
+        case Section::Decorations:
+            if (!forward(m_builder))
+                return false;
+            if (m_builder.complete())
+                valueRead();
+            return true;
+        }
+        return true;
+    }
+    template <typename Forward>
+    bool LevelReader::open(Forward forward)
+    {
+        m_depth++;
+        switch (m_section)
+        {
+        case Section::Root:
+        case Section::Skip:
+            return true;
+        case Section::PathData:
+            m_section = Section::Skip;
+            return true;
+        case Section::AngleData:
+        case Section::Actions:
+            if (!m_sectionOpen)
+            {
+                m_section = Section::Skip;
+                return true;
+            }
+            if (m_section == Section::AngleData)
+            {
+                // nested containers are ignored
+                if (m_depth == 3)
+                    m_diagnostics.warn(LoadDiagnostics::noAction, "angleData has an element that is not a number");
+                return true;
+            }
+            [[fallthrough]];
+        case Section::Settings:
+        case Section::Decorations:
+            return forward(m_builder);
+        }
+        return true;
+    }
+    template <typename Forward>
+    bool LevelReader::close(Forward forward)
+    {
+        m_depth--;
+        switch (m_section)
+        {
+        case Section::Root:
+            return true;
+        case Section::Skip:
+        case Section::PathData:
+            if (m_depth == 1)
+                m_section = Section::Root;
+            return true;
+        case Section::AngleData:
+            if (m_depth == 1)
+            {
+                m_section = Section::Root;
+                publishPreview();
+            }
+            return true;
+        case Section::Actions:
+            if (m_depth == 1)
+            {
+                flushActions();
+                m_section = Section::Root;
+                return true;
+            }
+            [[fallthrough]];
+        case Section::Settings:
+        case Section::Decorations:
+            if (!forward(m_builder))
+                return false;
+            if (m_builder.complete())
+                valueRead();
+            return true;
+        }
+        return true;
+    }
+    bool LevelReader::tick(const char* position)
+    {
+        if (!m_progress || ++m_ticks % ticksPerReport)
+            return true;
+        // In situ, the strings and numbers are moved towards the beginning of the text, never past the parser.
+        if (position >= m_json.data() && position < m_json.data() + m_json.size())
+            m_progress->stageProgress.store(static_cast<float>(position - m_json.data()) /
+                                                static_cast<float>(m_json.size()),
+                                            std::memory_order_relaxed);
+        return !m_progress->cancelled.load(std::memory_order_relaxed);
+    }
+    void LevelReader::publishPreview() const
+    {
+        if (!m_progress)
+            return;
+        const size_t count = std::min(m_level.tiles.size(), LoadProgress::previewTileCount + 1);
+        std::vector<double> angles;
+        angles.reserve(count);
+        for (size_t i = 1; i < count; i++)
+            angles.push_back(m_level.tiles[i].angle.deg());
+        m_progress->preview(std::move(angles));
+    }
+    void LevelReader::valueRead()
+    {
+        if (m_section == Section::Settings)
+        {
+            m_level.readSettings(m_builder.value(), m_diagnostics);
+            m_section = Section::Root;
+            m_builder.reset();
+        }
+        else if (m_section == Section::Decorations)
+        {
+            m_level.decorations = compactJson(m_builder.value());
+            m_section = Section::Root;
+            m_builder.reset();
+        }
+        else if (m_builder.values().size() >= std::min(m_level.m_parallelDecodeThreshold, maxActionBatch))
+            flushActions();
+    }
+    void LevelReader::flushActions()
+    {
+        const auto actions = m_builder.values();
+        auto events = m_level.newEvents(actions.data(), actions.size(), m_actionIndex, m_diagnostics);
+        for (size_t i = 0; i < events.size(); i++)
+            if (events[i])
+                addEvent(m_actionIndex + i, std::move(events[i]));
+        m_actionIndex += actions.size();
+        m_builder.reset();
+    }
+    void LevelReader::addEvent(const size_t action, std::shared_ptr<Event::Event> event)
+    {
+        // The tiles are only known for sure once angleData has been read (it takes precedence over pathData).
+        if (!m_hasAngleData || m_section == Section::AngleData)
+        {
+            m_pendingEvents.emplace_back(action, std::move(event));
+            return;
+        }
+        if (event->floor >= m_level.tiles.size())
+        {
+            m_diagnostics.warn(action, Level::floorOutOfRange(*event));
+            return;
+        }
+        m_level.tiles[event->floor].events.push_back(std::move(event));
+    }
+    void LevelReader::finish()
+    {
+        if (!m_hasAngleData)
+        {
+            if (!m_hasPathData)
+                throw LevelFormatException("the level has neither angleData nor pathData");
+            m_level.addPathTiles(m_pathData, m_diagnostics);
+            m_hasAngleData = true;
+            publishPreview();
+        }
+        m_section = Section::Root;
+        auto pendingEvents = std::move(m_pendingEvents);
+        for (auto& [action, event] : pendingEvents)
+            addEvent(action, std::move(event));
+    }
+
+    namespace
+    {
+        /**
+         * @brief Bit masks of the characters of a 64-byte block (bit i is byte i).
+         */
+        struct BlockMasks
+        {
+            uint64_t quote, backslash, open, close, comma, slash;
+        };
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        BlockMasks blockMasks(const char* const block) noexcept
+        {
+            BlockMasks masks{};
+            for (int i = 0; i < 64; i += 16)
+            {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+                const auto mask = [](const __m128i x, const char c)
+                { return static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8(c)))); };
+                // '[' and ']' differ from '{' and '}' only in the bit 0x20.
+                const __m128i folded = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+                masks.quote |= mask(bytes, '"') << i;
+                masks.backslash |= mask(bytes, '\\') << i;
+                masks.open |= mask(folded, '{') << i;
+                masks.close |= mask(folded, '}') << i;
+                masks.comma |= mask(bytes, ',') << i;
+                masks.slash |= mask(bytes, '/') << i;
+            }
+            return masks;
+        }
+#else
+        BlockMasks blockMasks(const char* const block) noexcept
+        {
+            // Eight bytes at a time: the high bit of a byte of equal(x, c) is set where x has c, and the
+            // multiplication gathers the high bits into the top byte.
+            constexpr uint64_t ones = 0x0101010101010101, lows = 0x7F7F7F7F7F7F7F7F;
+            const auto equal = [](const uint64_t x, const char c)
+            {
+                const uint64_t y = x ^ ones * static_cast<unsigned char>(c);
+                const uint64_t high = ~(((y & lows) + lows) | y | lows);
+                return ((high >> 7) * 0x0102040810204080) >> 56;
+            };
+            BlockMasks masks{};
+            for (int i = 0; i < 64; i += 8)
+            {
+                uint64_t x = 0;
+                for (int j = 7; j >= 0; j--) // byte j of x is block[i + j] whatever the endianness
+                    x = x << 8 | static_cast<unsigned char>(block[i + j]);
+                masks.quote |= equal(x, '"') << i;
+                masks.backslash |= equal(x, '\\') << i;
+                masks.open |= (equal(x, '{') | equal(x, '[')) << i;
+                masks.close |= (equal(x, '}') | equal(x, ']')) << i;
+                masks.comma |= equal(x, ',') << i;
+                masks.slash |= equal(x, '/') << i;
+            }
+            return masks;
+        }
+#endif
+
+        /**
+         * @brief Get the bits from the first one up to the last one of each pair (i.e. a prefix xor).
+         */
+        constexpr uint64_t prefixXor(uint64_t x) noexcept
+        {
+            x ^= x << 1;
+            x ^= x << 2;
+            x ^= x << 4;
+            x ^= x << 8;
+            x ^= x << 16;
+            x ^= x << 32;
+            return x;
+        }
+        /**
+         * @brief Get the bits in [first, last) of a mask.
+         */
+        constexpr uint64_t bitRange(const uint64_t mask, const int first, const int last) noexcept
+        {
+            const uint64_t low = last == 64 ? ~uint64_t{} : (uint64_t{1} << last) - 1;
+            return mask & low & (~uint64_t{} << first);
+        }
+    } // namespace
+
+    LevelMetadata LevelSkimmer::skim()
+    {
+        LevelMetadata metadata;
+        skipSpace();
+        if (m_p == m_end || *m_p != '{')
+            throw LevelFormatException("the level is not a json object");
+        m_p++;
+        bool hasSettings = false, hasTiles = false, hasAngleData = false, hasActions = false;
+        while (!(hasSettings && hasTiles && hasActions))
+        {
+            skipSpace();
+            if (m_p == m_end || *m_p == '}')
+                break;
+            if (*m_p == ',')
+            {
+                m_p++;
+                continue;
+            }
+            if (*m_p != '"')
+                throw LevelFormatException("the level is not a json object");
+            const char* const keyBegin = m_p + 1;
+            skipString();
+            const std::string_view key(keyBegin, std::max(keyBegin, m_p - 1) - keyBegin);
+            skipSpace();
+            if (m_p != m_end && *m_p == ':')
+                m_p++;
+            skipSpace();
+            if (m_p == m_end)
+                break;
+
+            if (key == "settings")
+            {
+                rapidjson::Document document;
+                rapidjson::MemoryStream ms(m_p, m_end - m_p);
+                if (const auto result =
+                        parseLevelJson<levelParseFlags | rapidjson::kParseStopWhenDoneFlag>(document, ms);
+                    result.IsError())
+                    throw LevelJsonException(result.Code());
+                m_p += ms.Tell();
+                JsonReader reader(document);
+                metadata.settings.read(reader);
+                hasSettings = true;
+            }
+            else if (key == "angleData" && *m_p == '[')
+            {
+                metadata.tileCount = countElements();
+                hasTiles = hasAngleData = true;
+            }
+            else if (key == "pathData" && *m_p == '"' && !hasAngleData)
+            {
+                metadata.tileCount = countCharacters();
+                hasTiles = true;
+            }
+            else if (key == "actions" && *m_p == '[')
+            {
+                metadata.actionCount = countElements();
+                hasActions = true;
+            }
+            else
+                skipValue();
+        }
+        return metadata;
+    }
+    void LevelSkimmer::skipSpace() noexcept
+    {
+        while (m_p != m_end)
+        {
+            if (const char c = *m_p; c == ' ' || c == '\n' || c == '\r' || c == '\t')
+                m_p++;
+            else if (c == '/' && m_end - m_p >= 2 && m_p[1] == '/')
+            {
+                const auto newline = static_cast<const char*>(std::memchr(m_p, '\n', m_end - m_p));
+                m_p = newline ? newline + 1 : m_end;
+            }
+            else if (c == '/' && m_end - m_p >= 2 && m_p[1] == '*')
+            {
+                const std::string_view rest(m_p + 2, m_end - m_p - 2);
+                const size_t close = rest.find("*/");
+                m_p = close == std::string_view::npos ? m_end : rest.data() + close + 2;
+            }
+            else
+                break;
+        }
+    }
+    void LevelSkimmer::skipString() noexcept
+    {
+        m_p++;
+        while (true)
+        {
+            const auto quote = static_cast<const char*>(std::memchr(m_p, '"', m_end - m_p));
+            if (!quote)
+            {
+                m_p = m_end;
+                return;
+            }
+            // The quote is escaped if an odd number of backslashes precede it.
+            const char* backslash = quote;
+            while (backslash != m_p && backslash[-1] == '\\')
+                backslash--;
+            m_p = quote + 1;
+            if ((quote - backslash) % 2 == 0)
+                return;
+        }
+    }
+    void LevelSkimmer::skipValue() noexcept
+    {
+        if (m_p == m_end)
+            return;
+        if (*m_p == '"')
+            skipString();
+        else if (*m_p == '{' || *m_p == '[')
+            skipContainer();
+        else
+        {
+            // a number, true, false, null, NaN or Infinity
+            while (m_p != m_end && !std::strchr(",]} \n\r\t/", *m_p))
+                m_p++;
+        }
+    }
+    size_t LevelSkimmer::skipContainer() noexcept
+    {
+        const char* const begin = m_p;
+        if (size_t commas; skipContainerFast(commas))
+            return commas;
+        m_p = begin;
+        size_t depth = 0, commas = 0;
+        while (m_p != m_end)
+        {
+            switch (*m_p)
+            {
+            case '"':
+                skipString();
+                continue;
+            case '/':
+                skipSpace();
+                if (m_p != m_end && *m_p == '/') // not a comment
+                    m_p++;
+                continue;
+            case ',':
+                commas += depth == 1;
+                break;
+            case '{':
+            case '[':
+                depth++;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0)
+                {
+                    m_p++;
+                    return commas;
+                }
+                break;
+            default:
+                break;
+            }
+            m_p++;
+        }
+        return commas;
+    }
+    bool LevelSkimmer::skipContainerFast(size_t& commas) noexcept
+    {
+        // 64 bytes at a time: the quotes that are not escaped delimit the strings, and only the brackets
+        // outside strings are visited (the commas between them are counted with popcount).
+        size_t depth = 0;
+        commas = 0;
+        bool inString = false, escape = false;
+        alignas(16) char tail[64]{};
+        for (const char* block = m_p; block < m_end; block += 64)
+        {
+            const char* bytes = block;
+            if (m_end - block < 64)
+            {
+                std::memcpy(tail, block, m_end - block);
+                bytes = tail;
+            }
+            const BlockMasks masks = blockMasks(bytes);
+
+            uint64_t escaped = 0;
+            if (masks.backslash || escape)
+            {
+                for (int i = 0; i < 64; i++)
+                {
+                    if (escape)
+                    {
+                        escaped |= uint64_t{1} << i;
+                        escape = false;
+                    }
+                    else if (bytes[i] == '\\')
+                        escape = true;
+                }
+            }
+            const uint64_t string = prefixXor(masks.quote & ~escaped) ^ (inString ? ~uint64_t{} : 0);
+            inString = string >> 63;
+            if (masks.slash & ~string)
+                return false; // a comment (or invalid json)
+            const uint64_t comma = masks.comma & ~string;
+
+            int segment = 0;
+            for (uint64_t brackets = (masks.open | masks.close) & ~string; brackets; brackets &= brackets - 1)
+            {
+                const int i = std::countr_zero(brackets);
+                if (depth == 1)
+                    commas += std::popcount(bitRange(comma, segment, i));
+                segment = i + 1;
+                if (masks.open >> i & 1)
+                    depth++;
+                else if (--depth == 0)
+                {
+                    m_p = block + i + 1;
+                    return true;
+                }
+            }
+            if (depth == 1)
+                commas += std::popcount(bitRange(comma, segment, 64));
+        }
+        m_p = m_end;
+        return true;
+    }
+    size_t LevelSkimmer::countElements() noexcept
+    {
+        const char* const open = m_p;
+        const size_t commas = skipContainer();
+        // The elements are separated by commas, but the array may be empty or end with a trailing comma.
+        const char* last = m_p - 1;
+        if (*last == ']')
+            last--;
+        while (last != open && (*last == ' ' || *last == '\n' || *last == '\r' || *last == '\t'))
+            last--;
+        if (last == open)
+            return 0;
+        return commas + (*last != ',');
+    }
+    size_t LevelSkimmer::countCharacters() noexcept
+    {
+        m_p++;
+        size_t count = 0;
+        while (m_p != m_end && *m_p != '"')
+        {
+            if (*m_p == '\\')
+            {
+                const ptrdiff_t escape = m_end - m_p >= 2 && m_p[1] == 'u' ? 6 : 2;
+                m_p += std::min(escape, m_end - m_p);
+            }
+            else
+                m_p++;
+            count++;
+        }
+        if (m_p != m_end)
+            m_p++;
+        return count;
+    }
+} // namespace AdoCpp
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <memory>
+#include <rapidjson/document.h>
+#include <rapidjson/reader.h>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Event.h"
+#include "ExactNumbers.h"
+
+namespace AdoCpp
+{
+    class Level;
+    struct LevelMetadata;
+    struct LoadDiagnostics;
+    struct LoadProgress;
+
+    /**
+     * Numbers are read as strings and converted exactly by parseNumber(), so the handlers must have a RawNumber()
+     * that calls it (see ExactNumberHandler and parseLevelJson()).
+     * @brief The rapidjson parse flags of level files (which may have comments and trailing commas).
+     */
+    constexpr unsigned levelParseFlags = rapidjson::kParseValidateEncodingFlag | rapidjson::kParseCommentsFlag |
+        rapidjson::kParseTrailingCommasFlag | rapidjson::kParseNanAndInfFlag | rapidjson::kParseNumbersAsStringsFlag;
+
+    /**
+     * @brief Parse level json (see levelParseFlags) into a document.
+     * @tparam parseFlags The parse flags, including levelParseFlags.
+     * @tparam SourceEncoding The encoding of the stream.
+     * @param document The document.
+     * @param is The stream.
+     * @return The result of the parse.
+     */
+    template <unsigned parseFlags = levelParseFlags, typename SourceEncoding = rapidjson::UTF8<>, typename InputStream>
+    rapidjson::ParseResult parseLevelJson(rapidjson::Document& document, InputStream& is)
+    {
+        rapidjson::GenericReader<SourceEncoding, rapidjson::UTF8<>> reader;
+        rapidjson::ParseResult result;
+        auto generator = [&reader, &result, &is](rapidjson::Document& handler)
+        {
+            ExactNumberHandler numbers(handler);
+            result = reader.template Parse<parseFlags>(is, numbers);
+            return !result.IsError();
+        };
+        document.Populate(generator);
+        return result;
+    }
+
+    /**
+     * @brief A rapidjson SAX handler that builds json values one after another.
+     *
+     * The values are kept until reset(), which reuses the memory, so reading many small objects
+     * in batches does not allocate once the first few batches have been read.
+     */
+    class JsonValueBuilder
+    {
+    public:
+        JsonValueBuilder();
+        JsonValueBuilder(const JsonValueBuilder&) = delete;
+        JsonValueBuilder& operator=(const JsonValueBuilder&) = delete;
+
+        bool Null();
+        bool Bool(bool b);
+        bool Int(int i);
+        bool Uint(unsigned u);
+        bool Int64(int64_t i);
+        bool Uint64(uint64_t u);
+        bool Double(double d);
+        bool RawNumber(const char* str, rapidjson::SizeType length, bool copy);
+        bool String(const char* str, rapidjson::SizeType length, bool copy);
+        bool StartObject();
+        bool Key(const char* str, rapidjson::SizeType length, bool copy);
+        bool EndObject(rapidjson::SizeType memberCount);
+        bool StartArray();
+        bool EndArray(rapidjson::SizeType elementCount);
+
+        /**
+         * @brief Get whether a whole value has been read (and no other one has been started).
+         */
+        [[nodiscard]] bool complete() const noexcept;
+        /**
+         * @brief Get whether no value has been started.
+         */
+        [[nodiscard]] bool idle() const noexcept;
+        /**
+         * @brief Get the last value that has been read (valid until reset()).
+         */
+        [[nodiscard]] rapidjson::Value& value();
+        /**
+         * @brief Get every value that has been read since reset().
+         */
+        [[nodiscard]] std::span<rapidjson::Value> values();
+        /**
+         * @brief Forget the values and get ready for the next ones.
+         */
+        void reset();
+
+    private:
+        alignas(std::max_align_t) char m_buffer[8192];
+        rapidjson::MemoryPoolAllocator<> m_alloc;
+        std::vector<rapidjson::Value> m_stack;
+        size_t m_depth = 0;
+    };
+
+    /**
+     * @brief A rapidjson SAX handler that reads a level straight into a Level object, without a document.
+     *
+     * angleData/pathData become tiles, settings is read as one small value and the actions are built
+     * into events in batches (see Level::parallelDecodeThreshold()), decorations are kept as compact json
+     * and unknown members are skipped. Invalid actions and members are reported to a LoadDiagnostics.
+     */
+    class LevelReader
+    {
+    public:
+        /**
+         * @brief Constructor. Clears the level.
+         * @param level The level to read into.
+         * @param diagnostics Receives the warnings.
+         * @param progress Receives the progress and the preview, and is checked for cancellation (may be null).
+         * @param json The in-situ json text the progress is measured in.
+         */
+        LevelReader(Level& level, LoadDiagnostics& diagnostics, LoadProgress* progress = nullptr,
+                    std::string_view json = {});
+
+        bool Null();
+        bool Bool(bool b);
+        bool Int(int i);
+        bool Uint(unsigned u);
+        bool Int64(int64_t i);
+        bool Uint64(uint64_t u);
+        bool Double(double d);
+        bool RawNumber(const char* str, rapidjson::SizeType length, bool copy);
+        bool String(const char* str, rapidjson::SizeType length, bool copy);
+        bool StartObject();
+        bool Key(const char* str, rapidjson::SizeType length, bool copy);
+        bool EndObject(rapidjson::SizeType memberCount);
+        bool StartArray();
+        bool EndArray(rapidjson::SizeType elementCount);
+
+        /**
+         * @brief Finish the level after the whole document has been read.
+         * @throw LevelFormatException If the level has neither angleData nor pathData.
+         */
+        void finish();
+
+    private:
+        /**
+         * @brief The largest number of actions kept before they are built into events.
+         */
+        static constexpr size_t maxActionBatch = 65536;
+        /**
+         * @brief The number of keys and numbers between two progress reports.
+         */
+        static constexpr size_t ticksPerReport = 4096;
+
+        enum class Section
+        {
+            Root,
+            AngleData,
+            PathData,
+            Settings,
+            Actions,
+            Decorations,
+            Skip
+        };
+
+        template <typename Forward>
+        bool scalar(Forward forward, const double* number = nullptr, const char* str = nullptr, size_t length = 0);
+        template <typename Forward>
+        bool open(Forward forward);
+        template <typename Forward>
+        bool close(Forward forward);
+        /**
+         * @brief Report the progress now and then.
+         * @param position Where the parser is in the json text.
+         * @return Whether the load goes on (false once it has been cancelled).
+         */
+        bool tick(const char* position);
+        /**
+         * @brief Give the angles of the first tiles to the progress.
+         */
+        void publishPreview() const;
+        void valueRead();
+        void flushActions();
+        void addEvent(size_t action, std::shared_ptr<Event::Event> event);
+
+        Level& m_level;
+        LoadDiagnostics& m_diagnostics;
+        LoadProgress* m_progress;
+        std::string_view m_json;
+        size_t m_ticks = 0;
+        JsonValueBuilder m_builder;
+        Section m_section = Section::Root;
+        /**
+         * @brief The number of containers currently open.
+         */
+        size_t m_depth = 0;
+        /**
+         * @brief Whether the array of the current section has been opened.
+         */
+        bool m_sectionOpen = false;
+        bool m_hasAngleData = false;
+        bool m_hasPathData = false;
+        std::string m_pathData;
+        /**
+         * @brief The index of the first action of the current batch.
+         */
+        size_t m_actionIndex = 0;
+        /**
+         * @brief The events read before the tiles are known (when actions come before angleData/pathData),
+         * with the index of their action.
+         */
+        std::vector<std::pair<size_t, std::shared_ptr<Event::Event>>> m_pendingEvents;
+    };
+
+    /**
+     * @brief Reads the metadata of a level (see Level::peekMetadata()) by skimming its UTF-8 json text.
+     *
+     * Strings are skipped with memchr and containers by matching brackets, so nothing but settings
+     * is parsed or allocated.
+     */
+    class LevelSkimmer
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param json The json text (without a byte order mark).
+         */
+        explicit LevelSkimmer(std::string_view json) : m_p(json.data()), m_end(json.data() + json.size()) {}
+
+        /**
+         * @brief Skim the level.
+         * @throw LevelFormatException If the text is not a json object.
+         * @throw LevelJsonException If the settings are not valid json.
+         */
+        [[nodiscard]] LevelMetadata skim();
+
+    private:
+        /**
+         * @brief Skip whitespace and comments.
+         */
+        void skipSpace() noexcept;
+        /**
+         * @brief Skip a string (the current character is its opening quote).
+         */
+        void skipString() noexcept;
+        void skipValue() noexcept;
+        /**
+         * @brief Skip an object or an array (the current character is '{' or '[').
+         * @return The number of commas directly inside it.
+         */
+        size_t skipContainer() noexcept;
+        /**
+         * @brief skipContainer() a block at a time, with SSE2 if it is available.
+         * @return Whether it succeeded (it gives up on comments).
+         */
+        bool skipContainerFast(size_t& commas) noexcept;
+        /**
+         * @brief Skip an array (the current character is '[') and count its elements.
+         */
+        size_t countElements() noexcept;
+        /**
+         * @brief Skip a string (the current character is its opening quote) and count its characters.
+         */
+        size_t countCharacters() noexcept;
+
+        const char* m_p;
+        const char* m_end;
+    };
+} // namespace AdoCpp
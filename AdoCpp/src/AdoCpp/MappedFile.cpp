@@ -0,0 +1,129 @@
+#include "MappedFile.h"
+
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AdoCpp
+{
+    MappedFile::MappedFile(const std::filesystem::path& path) { open(path); }
+    MappedFile::MappedFile(MappedFile&& other) noexcept :
+        m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+        m_mapped(std::exchange(other.m_mapped, false)), m_buffer(std::move(other.m_buffer))
+    {
+    }
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_mapped = std::exchange(other.m_mapped, false);
+            m_buffer = std::move(other.m_buffer);
+        }
+        return *this;
+    }
+    MappedFile::~MappedFile() { close(); }
+
+    bool MappedFile::open(const std::filesystem::path& path)
+    {
+        close();
+        size_t pageSize;
+#ifdef _WIN32
+        const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            return false;
+        }
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        pageSize = systemInfo.dwPageSize;
+        if (m_size != 0 && m_size % pageSize != 0)
+        {
+            if (const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr))
+            {
+                m_data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+                CloseHandle(mapping);
+                m_mapped = m_data != nullptr;
+            }
+        }
+        CloseHandle(file);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            return false;
+        struct stat st{};
+        if (fstat(fd, &st) == -1)
+        {
+            ::close(fd);
+            return false;
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        if (m_size != 0 && m_size % pageSize != 0)
+        {
+            // The rest of the last page reads as zeros, which terminates the buffer.
+            if (void* p = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0); p != MAP_FAILED)
+            {
+                madvise(p, m_size, MADV_SEQUENTIAL);
+                m_data = static_cast<char*>(p);
+                m_mapped = true;
+            }
+        }
+        ::close(fd);
+#endif
+        if (m_mapped)
+            return true;
+
+        // No room for the terminator (or the mapping failed): read the file instead.
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs.is_open())
+        {
+            m_size = 0;
+            return false;
+        }
+        m_buffer = std::make_unique<char[]>(m_size + 1);
+        ifs.read(m_buffer.get(), static_cast<std::streamsize>(m_size));
+        m_size = static_cast<size_t>(ifs.gcount());
+        m_buffer[m_size] = '\0';
+        m_data = m_buffer.get();
+        return true;
+    }
+    void MappedFile::close() noexcept
+    {
+        if (m_mapped)
+        {
+#ifdef _WIN32
+            UnmapViewOfFile(m_data);
+#else
+            munmap(m_data, m_size);
+#endif
+        }
+        m_buffer.reset();
+        m_data = nullptr;
+        m_size = 0;
+        m_mapped = false;
+    }
+    bool MappedFile::isOpen() const noexcept { return m_data != nullptr; }
+    char* MappedFile::data() noexcept { return m_data; }
+    const char* MappedFile::data() const noexcept { return m_data; }
+    size_t MappedFile::size() const noexcept { return m_size; }
+} // namespace AdoCpp
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+namespace AdoCpp
+{
+    /**
+     * @brief A private, writable memory mapping of a whole file.
+     *
+     * Writes stay in memory and never reach the file, so the buffer can be parsed in situ.
+     * The buffer is always followed by a '\0' (if the file ends exactly on a page boundary,
+     * it is read into a heap buffer instead of being mapped).
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        /**
+         * @brief Map a file.
+         * @param path The path to the file.
+         */
+        explicit MappedFile(const std::filesystem::path& path);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        ~MappedFile();
+
+        /**
+         * @brief Map a file, unmapping the previous one.
+         * @param path The path to the file.
+         * @return Whether the file could be opened.
+         */
+        bool open(const std::filesystem::path& path);
+        /**
+         * @brief Unmap the file.
+         */
+        void close() noexcept;
+
+        [[nodiscard]] bool isOpen() const noexcept;
+        [[nodiscard]] char* data() noexcept;
+        [[nodiscard]] const char* data() const noexcept;
+        /**
+         * @brief Get the size of the file (without the terminating '\0').
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+    private:
+        char* m_data = nullptr;
+        size_t m_size = 0;
+        bool m_mapped = false;
+        std::unique_ptr<char[]> m_buffer;
+    };
+} // namespace AdoCpp
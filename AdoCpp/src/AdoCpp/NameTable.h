@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace AdoCpp
+{
+    /**
+     * The table is built at compile time from one of the cstr* name arrays: a seed is searched for
+     * until every name hashes to its own slot, so a lookup is one hash and one string comparison.
+     * @brief A perfect hash table from names to their indices in a name array.
+     * @tparam N The number of names.
+     */
+    template <size_t N>
+    class NameTable
+    {
+        static_assert(N < 255, "AdoCpp::NameTable stores the indices in bytes");
+
+    public:
+        /**
+         * @brief Constructor.
+         * @param names The names (their indices are what find() returns).
+         */
+        consteval explicit NameTable(const char* const (&names)[N])
+        {
+            for (size_t i = 0; i < N; i++)
+                m_names[i] = names[i];
+            for (m_seed = 0; m_seed < 65536; m_seed++)
+                if (build())
+                    return;
+            throw "AdoCpp::NameTable: no perfect hash found (are the names unique?)";
+        }
+
+        /**
+         * @brief Find a name.
+         * @param name The name.
+         * @return The index of the name, or std::nullopt if it is not in the table.
+         */
+        [[nodiscard]] constexpr std::optional<size_t> find(const std::string_view name) const noexcept
+        {
+            if (const size_t index = m_slots[slot(name, m_seed)]; index != 0 && m_names[index - 1] == name)
+                return index - 1;
+            return std::nullopt;
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept { return N; }
+        [[nodiscard]] constexpr std::string_view operator[](const size_t index) const noexcept
+        {
+            return m_names[index];
+        }
+
+    private:
+        static constexpr size_t tableSize = std::bit_ceil(N * 4);
+
+        [[nodiscard]] static constexpr size_t slot(const std::string_view name, const uint32_t seed) noexcept
+        {
+            // FNV-1a
+            uint32_t hash = 2166136261u ^ seed * 0x9E3779B9u;
+            for (const char c : name)
+            {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 16777619u;
+            }
+            return (hash ^ hash >> 16) & (tableSize - 1);
+        }
+        constexpr bool build()
+        {
+            m_slots = {};
+            for (size_t i = 0; i < N; i++)
+            {
+                auto& s = m_slots[slot(m_names[i], m_seed)];
+                if (s != 0)
+                    return false;
+                s = static_cast<uint8_t>(i + 1);
+            }
+            return true;
+        }
+
+        std::array<std::string_view, N> m_names{};
+        /**
+         * @brief The index of the name in each slot plus one (0 for an empty slot).
+         */
+        std::array<uint8_t, tableSize> m_slots{};
+        uint32_t m_seed = 0;
+    };
+} // namespace AdoCpp
@@ -0,0 +1,115 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace AdoCpp
+{
+    ThreadPool::ThreadPool(size_t threadCount)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        m_workers.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++)
+            m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+    size_t ThreadPool::size() const noexcept { return m_workers.size(); }
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.push(std::move(task));
+        }
+        m_cv.notify_one();
+    }
+    void ThreadPool::parallelFor(const size_t begin, const size_t end, size_t grain,
+                                 const std::function<void(size_t, size_t)>& func)
+    {
+        if (begin >= end)
+            return;
+        grain = std::max<size_t>(grain, 1);
+        const size_t chunks = (end - begin + grain - 1) / grain;
+        if (chunks == 1)
+        {
+            func(begin, end);
+            return;
+        }
+
+        // The helpers may still be queued when the caller returns, so the state they touch is shared.
+        struct State
+        {
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            std::exception_ptr exception;
+            std::mutex mutex;
+            std::condition_variable cv;
+        };
+        const auto state = std::make_shared<State>();
+        const size_t total = chunks;
+        auto run = [state, begin, end, grain, total, &func]
+        {
+            size_t finished = 0;
+            for (size_t chunk; (chunk = state->next.fetch_add(1)) < total; finished++)
+            {
+                const size_t b = begin + chunk * grain, e = std::min(end, b + grain);
+                try
+                {
+                    func(b, e);
+                }
+                catch (...)
+                {
+                    std::lock_guard lock(state->mutex);
+                    if (!state->exception)
+                        state->exception = std::current_exception();
+                }
+            }
+            if (finished != 0 && state->done.fetch_add(finished) + finished == total)
+            {
+                std::lock_guard lock(state->mutex);
+                state->cv.notify_all();
+            }
+        };
+        // func is only dereferenced while a chunk is claimed, and the caller waits for all of them.
+        for (size_t i = 0, helpers = std::min(size(), chunks - 1); i < helpers; i++)
+            submit(run);
+        run();
+
+        std::unique_lock lock(state->mutex);
+        state->cv.wait(lock, [&state, total] { return state->done.load() == total; });
+        if (state->exception)
+            std::rethrow_exception(state->exception);
+    }
+    ThreadPool& ThreadPool::global()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+    void ThreadPool::workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(m_mutex);
+                m_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                if (m_stop && m_tasks.empty())
+                    return;
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+            task();
+        }
+    }
+} // namespace AdoCpp
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace AdoCpp
+{
+    /**
+     * @brief A fixed-size pool of worker threads.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param threadCount The number of worker threads (0 means hardware concurrency).
+         */
+        explicit ThreadPool(size_t threadCount = 0);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Destructor. Finishes the queued tasks and joins the workers.
+         */
+        ~ThreadPool();
+
+        /**
+         * @brief Get the number of worker threads.
+         * @return The number of worker threads.
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * @brief Queue a task.
+         * @param task The task.
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * Split [begin, end) into chunks of at most grain elements and run func(chunkBegin, chunkEnd) for each of
+         * them on the workers. The calling thread takes part as well and returns when every chunk is done.
+         * The first exception thrown by func is rethrown.
+         * @brief Run a loop in parallel.
+         * @param begin The first index.
+         * @param end The index after the last one.
+         * @param grain The maximum size of a chunk.
+         * @param func The function.
+         */
+        void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& func);
+
+        /**
+         * @brief Get the pool shared by the library (created on first use).
+         * @return The pool.
+         */
+        static ThreadPool& global();
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> m_workers;
+        std::queue<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        bool m_stop = false;
+    };
+} // namespace AdoCpp
@@ -1,4 +1,5 @@
 #pragma once
+#include <limits>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -10,6 +11,7 @@
 #include "Easing.h"
 #include "Math/Angle.h"
 #include "Math/Vector2.h"
+#include "NameTable.h"
 #include "Utils.h"
 
 namespace AdoCpp
@@ -38,11 +40,17 @@ namespace AdoCpp
     {
         return cstrTrackColorType[static_cast<int>(trackColorType)];
     }
-    constexpr TrackColorType cstr2trackColorType(const char* cstr)
+    constexpr NameTable trackColorTypeNames(cstrTrackColorType);
+    constexpr std::optional<TrackColorType> tryCstr2trackColorType(const std::string_view str) noexcept
     {
-        for (int i = 0; i < std::size(cstrTrackColorType); ++i)
-            if (strcmp(cstr, cstrTrackColorType[i]) == 0)
-                return static_cast<TrackColorType>(i);
+        if (const auto index = trackColorTypeNames.find(str))
+            return static_cast<TrackColorType>(*index);
+        return std::nullopt;
+    }
+    constexpr TrackColorType cstr2trackColorType(const char* const cstr)
+    {
+        if (const auto value = tryCstr2trackColorType(cstr))
+            return *value;
         throw std::invalid_argument(cstr);
     }
 
@@ -60,11 +68,17 @@ namespace AdoCpp
     {
         return cstrTrackStyle[static_cast<int>(trackStyle)];
     }
-    constexpr TrackStyle cstr2trackStyle(const char* cstr)
+    constexpr NameTable trackStyleNames(cstrTrackStyle);
+    constexpr std::optional<TrackStyle> tryCstr2trackStyle(const std::string_view str) noexcept
     {
-        for (int i = 0; i < std::size(cstrTrackStyle); ++i)
-            if (strcmp(cstr, cstrTrackStyle[i]) == 0)
-                return static_cast<TrackStyle>(i);
+        if (const auto index = trackStyleNames.find(str))
+            return static_cast<TrackStyle>(*index);
+        return std::nullopt;
+    }
+    constexpr TrackStyle cstr2trackStyle(const char* const cstr)
+    {
+        if (const auto value = tryCstr2trackStyle(cstr))
+            return *value;
         throw std::invalid_argument(cstr);
     }
 
@@ -86,11 +100,17 @@ namespace AdoCpp
     {
         return cstrTrackAnimation[static_cast<int>(trackAnimation)];
     }
-    constexpr TrackAnimation cstr2trackAnimation(const char* cstr)
+    constexpr NameTable trackAnimationNames(cstrTrackAnimation);
+    constexpr std::optional<TrackAnimation> tryCstr2trackAnimation(const std::string_view str) noexcept
     {
-        for (int i = 0; i < std::size(cstrTrackAnimation); ++i)
-            if (strcmp(cstr, cstrTrackAnimation[i]) == 0)
-                return static_cast<TrackAnimation>(i);
+        if (const auto index = trackAnimationNames.find(str))
+            return static_cast<TrackAnimation>(*index);
+        return std::nullopt;
+    }
+    constexpr TrackAnimation cstr2trackAnimation(const char* const cstr)
+    {
+        if (const auto value = tryCstr2trackAnimation(cstr))
+            return *value;
         throw std::invalid_argument(cstr);
     }
     enum class TrackDisappearAnimation
@@ -110,11 +130,18 @@ namespace AdoCpp
     {
         return cstrTrackDisappearAnimation[static_cast<int>(trackDisappearAnimation)];
     }
-    constexpr TrackDisappearAnimation cstr2trackDisappearAnimation(const char* cstr)
+    constexpr NameTable trackDisappearAnimationNames(cstrTrackDisappearAnimation);
+    constexpr std::optional<TrackDisappearAnimation>
+    tryCstr2trackDisappearAnimation(const std::string_view str) noexcept
+    {
+        if (const auto index = trackDisappearAnimationNames.find(str))
+            return static_cast<TrackDisappearAnimation>(*index);
+        return std::nullopt;
+    }
+    constexpr TrackDisappearAnimation cstr2trackDisappearAnimation(const char* const cstr)
     {
-        for (int i = 0; i < std::size(cstrTrackDisappearAnimation); ++i)
-            if (strcmp(cstr, cstrTrackDisappearAnimation[i]) == 0)
-                return static_cast<TrackDisappearAnimation>(i);
+        if (const auto value = tryCstr2trackDisappearAnimation(cstr))
+            return *value;
         throw std::invalid_argument(cstr);
     }
 
@@ -129,11 +156,17 @@ namespace AdoCpp
     {
         return cstrTrackColorPulse[static_cast<int>(trackColorPulse) + 1];
     }
-    constexpr TrackColorPulse cstr2trackColorPulse(const char* cstr)
+    constexpr NameTable trackColorPulseNames(cstrTrackColorPulse);
+    constexpr std::optional<TrackColorPulse> tryCstr2trackColorPulse(const std::string_view str) noexcept
+    {
+        if (const auto index = trackColorPulseNames.find(str))
+            return static_cast<TrackColorPulse>(*index - 1);
+        return std::nullopt;
+    }
+    constexpr TrackColorPulse cstr2trackColorPulse(const char* const cstr)
     {
-        for (int i = 0; i < std::size(cstrTrackColorPulse); ++i)
-            if (strcmp(cstr, cstrTrackColorPulse[i]) == 0)
-                return static_cast<TrackColorPulse>(i - 1);
+        if (const auto value = tryCstr2trackColorPulse(cstr))
+            return *value;
         throw std::invalid_argument(cstr);
     }
 
@@ -188,11 +221,17 @@ namespace AdoCpp
     {
         return cstrHitsound[static_cast<int>(hitsound)];
     }
-    constexpr Hitsound cstr2hitsound(const char* cstr)
+    constexpr NameTable hitsoundNames(cstrHitsound);
+    constexpr std::optional<Hitsound> tryCstr2hitsound(const std::string_view str) noexcept
+    {
+        if (const auto index = hitsoundNames.find(str))
+            return static_cast<Hitsound>(*index);
+        return std::nullopt;
+    }
+    constexpr Hitsound cstr2hitsound(const char* const cstr)
     {
-        for (int i = 0; i < std::size(cstrHitsound); ++i)
-            if (strcmp(cstr, cstrHitsound[i]) == 0)
-                return static_cast<Hitsound>(i);
+        if (const auto value = tryCstr2hitsound(cstr))
+            return *value;
         throw std::invalid_argument(cstr);
     }
 
@@ -301,6 +340,18 @@ namespace AdoCpp
         double beatsAhead = 0;
         TrackDisappearAnimation trackDisappearAnimation = TrackDisappearAnimation::None;
         double beatsBehind = 0;
+        /**
+         * @brief When the appear animation starts (in seconds).
+         */
+        double appearSeconds = -std::numeric_limits<double>::infinity();
+        /**
+         * @brief When the disappear animation starts (in seconds).
+         */
+        double disappearSeconds = std::numeric_limits<double>::infinity();
+        /**
+         * @brief How long the appear and disappear animations last (in seconds).
+         */
+        double animationDuration = 0;
 
         Hitsound hitsound = Hitsound::Kick;
         double hitsoundVolume = 100;
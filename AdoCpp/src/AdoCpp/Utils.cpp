@@ -14,6 +14,13 @@ namespace AdoCpp
         val->PushBack(rapidjson::StringRef(relativeToTile2cstr(relativeTo)), alloc);
         return val;
     }
+    void RelativeIndex::write(JsonWriter& writer) const
+    {
+        writer.startArray();
+        writer.int64(index);
+        writer.string(relativeToTile2cstr(relativeTo));
+        writer.endArray();
+    }
     bool toBool(const rapidjson::Value& data)
     {
         if (data.IsBool())
@@ -78,4 +85,25 @@ namespace AdoCpp
         else
             jsonValue.AddMember(rapidjson::StringRef(name), value, alloc);
     }
+    void writeTag(JsonWriter& writer, const std::vector<std::string>& tags, const bool repeatEvents)
+    {
+        char tagBuf[1145]{};
+        tags2cstr(tags, tagBuf, 1145);
+        writer.member(repeatEvents ? "tag" : "eventTag", tagBuf);
+    }
+    void writeOptionalPoint(JsonWriter& writer, const std::string_view name, const OptionalPoint& op)
+    {
+        if (!op.first && !op.second)
+            return;
+        writer.key(name);
+        writer.startArray();
+        for (const auto& coordinate : {op.first, op.second})
+        {
+            if (coordinate)
+                writer.number(*coordinate);
+            else
+                writer.null();
+        }
+        writer.endArray();
+    }
 } // namespace AdoCpp
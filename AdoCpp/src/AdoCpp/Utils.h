@@ -1,12 +1,18 @@
 #pragma once
 
+#include <array>
 #include <complex.h>
+#include <limits>
 #include <optional>
 #include <rapidjson/document.h>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "JsonWriter.h"
+#include "NameTable.h"
+
 namespace AdoCpp
 {
     [[noreturn]] inline void unreachable()
@@ -76,19 +82,48 @@ namespace AdoCpp
         '5', '6', '7', '8', '!'
     };
     // clang-format on
+    /**
+     * @brief The angle of each pathData character, indexed by the character (NaN if it is not one).
+     */
+    constexpr auto pathAngles = []
+    {
+        std::array<double, 256> table{};
+        table.fill(std::numeric_limits<double>::quiet_NaN());
+        for (size_t i = 0; i < std::size(paths); ++i)
+            table[static_cast<unsigned char>(paths[i])] = angles[i];
+        return table;
+    }();
+    constexpr std::optional<double> tryPath2angle(const char path) noexcept
+    {
+        if (const double angle = pathAngles[static_cast<unsigned char>(path)]; angle == angle)
+            return angle;
+        return std::nullopt;
+    }
     constexpr double path2angle(const char path)
     {
-        for (size_t i = 0; i < std::size(angles); ++i)
-            if (path == paths[i])
-                return angles[i];
+        if (const auto angle = tryPath2angle(path))
+            return *angle;
         throw std::invalid_argument("Invalid path");
     }
-    constexpr char angle2path(const char angle)
+    constexpr std::optional<char> tryAngle2path(const double angle) noexcept
     {
-        for (size_t i = 0; i < std::size(angles); ++i)
+        // The first 24 characters are the multiples of 15 degrees in order.
+        if (angle >= 0 && angle < 360)
+        {
+            if (const int i = static_cast<int>(angle / 15); i * 15.0 == angle)
+                return paths[i];
+            return std::nullopt;
+        }
+        for (size_t i = 24; i < std::size(angles); ++i)
             if (angle == angles[i])
                 return paths[i];
-        throw std::invalid_argument("Invalid path");
+        return std::nullopt;
+    }
+    constexpr char angle2path(const double angle)
+    {
+        if (const auto path = tryAngle2path(angle))
+            return *path;
+        throw std::invalid_argument("Invalid angle");
     }
 
 
@@ -99,11 +134,17 @@ namespace AdoCpp
         End
     };
     constexpr const char* const cstrRelativeToTile[] = {"Start", "ThisTile", "End"};
+    constexpr NameTable relativeToTileNames(cstrRelativeToTile);
+    constexpr std::optional<RelativeToTile> tryCstr2relativeToTile(const std::string_view str) noexcept
+    {
+        if (const auto index = relativeToTileNames.find(str))
+            return static_cast<RelativeToTile>(*index);
+        return std::nullopt;
+    }
     constexpr RelativeToTile cstr2relativeToTile(const char* const cstr)
     {
-        for (int i = 0; i < std::size(cstrRelativeToTile); ++i)
-            if (strcmp(cstr, cstrRelativeToTile[i]) == 0)
-                return static_cast<RelativeToTile>(i);
+        if (const auto value = tryCstr2relativeToTile(cstr))
+            return *value;
         throw std::invalid_argument("Invalid Cstr");
     }
     constexpr const char* relativeToTile2cstr(const RelativeToTile& rel)
@@ -114,7 +155,10 @@ namespace AdoCpp
     struct RelativeIndex
     {
         RelativeIndex() = default;
-        RelativeIndex(const int64_t& index, const RelativeToTile& relativeTo) : index(index), relativeTo(relativeTo) {}
+        constexpr RelativeIndex(const int64_t& index, const RelativeToTile& relativeTo) :
+            index(index), relativeTo(relativeTo)
+        {
+        }
 
         explicit RelativeIndex(const rapidjson::Value& data) :
             index(data[0].GetInt64()), relativeTo(cstr2relativeToTile(data[1].GetString()))
@@ -123,6 +167,7 @@ namespace AdoCpp
         int64_t index{};
         RelativeToTile relativeTo{};
         std::unique_ptr<rapidjson::Value> intoJson(rapidjson::Document::AllocatorType& alloc) const;
+        void write(JsonWriter& writer) const;
     };
 
     enum class RelativeToCamera
@@ -133,11 +178,17 @@ namespace AdoCpp
         LastPosition
     };
     constexpr const char* const cstrRelativeToCamera[] = {"Player", "Tile", "Global", "LastPosition"};
+    constexpr NameTable relativeToCameraNames(cstrRelativeToCamera);
+    constexpr std::optional<RelativeToCamera> tryCstr2relativeToCamera(const std::string_view str) noexcept
+    {
+        if (const auto index = relativeToCameraNames.find(str))
+            return static_cast<RelativeToCamera>(*index);
+        return std::nullopt;
+    }
     constexpr RelativeToCamera cstr2relativeToCamera(const char* const cstr)
     {
-        for (int i = 0; i < std::size(cstrRelativeToCamera); ++i)
-            if (strcmp(cstr, cstrRelativeToCamera[i]) == 0)
-                return static_cast<RelativeToCamera>(i);
+        if (const auto value = tryCstr2relativeToCamera(cstr))
+            return *value;
         throw std::invalid_argument("Invalid Cstr");
     }
     constexpr const char* relativeToCamera2cstr(const RelativeToCamera& rel)
@@ -186,4 +237,15 @@ namespace AdoCpp
                 rapidjson::Document::AllocatorType& alloc, bool repeatEvents = false);
     void autoRemoveDecimalPart(rapidjson::Value& jsonValue, const char* name, double value,
                                rapidjson::Document::AllocatorType& alloc);
+
+    /**
+     * @brief Write the tags as a member of an action (eventTag, or tag for RepeatEvents).
+     */
+    void writeTag(JsonWriter& writer, const std::vector<std::string>& tags, bool repeatEvents = false);
+    /**
+     * @brief Write an OptionalPoint as a member, with null for a missing coordinate.
+     *
+     * Nothing is written if both coordinates are missing.
+     */
+    void writeOptionalPoint(JsonWriter& writer, std::string_view name, const OptionalPoint& op);
 } // namespace AdoCpp
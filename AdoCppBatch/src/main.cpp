@@ -0,0 +1,331 @@
+#include <AdoCpp.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+constexpr const char* usage =
+    "Usage: AdoCppBatch <input directory> [options]\n"
+    "Loads, parses and validates every .adofai file under the directory.\n"
+    "  --output <directory>    Write the levels there, keeping the directory tree.\n"
+    "  --format json|binary    The format of the written levels (default: json).\n"
+    "  --optimize              Remove the events that have no effect (see AdoCpp::Level::optimize()) and check\n"
+    "                          that the timing and the geometry of the tiles are unchanged.\n"
+    "  --verify                Load the written levels back and check that they are unchanged.\n"
+    "  --jobs <n>              The number of threads (default: hardware concurrency).\n"
+    "  --report <file>         Write the per-file report (csv) there instead of to the standard output.\n";
+
+enum class Format
+{
+    Json,
+    Binary
+};
+
+struct Options
+{
+    std::filesystem::path input, output, report;
+    Format format = Format::Json;
+    bool optimize = false;
+    bool verify = false;
+    size_t jobs = 0;
+};
+
+enum class Status
+{
+    Ok,       //!< Loaded and parsed without any warning.
+    Warnings, //!< Loaded with warnings (see AdoCpp::LoadDiagnostics).
+    Invalid,  //!< Loaded, but the timing or the geometry is not finite, or changed when optimizing or converting.
+    Failed    //!< Could not be loaded or written.
+};
+constexpr const char* const cstrStatus[] = {"ok", "warnings", "invalid", "failed"};
+
+struct Result
+{
+    std::filesystem::path path;
+    uintmax_t size = 0;
+    Status status = Status::Ok;
+    size_t tiles = 0, events = 0, warnings = 0, removed = 0;
+    double loadMs = 0, parseMs = 0, optimizeMs = 0, writeMs = 0, verifyMs = 0;
+    std::string message;
+};
+
+std::optional<Options> parseOptions(const int argc, char* argv[])
+{
+    if (argc < 2)
+        return std::nullopt;
+    Options options;
+    options.input = argv[1];
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--output" && hasValue)
+            options.output = argv[++i];
+        else if (arg == "--format" && hasValue)
+        {
+            const std::string_view format = argv[++i];
+            if (format == "json")
+                options.format = Format::Json;
+            else if (format == "binary")
+                options.format = Format::Binary;
+            else
+                return std::nullopt;
+        }
+        else if (arg == "--optimize")
+            options.optimize = true;
+        else if (arg == "--verify")
+            options.verify = true;
+        else if (arg == "--jobs" && hasValue)
+        {
+            const std::string_view jobs = argv[++i];
+            if (const auto [ptr, ec] = std::from_chars(jobs.data(), jobs.data() + jobs.size(), options.jobs);
+                ec != std::errc() || ptr != jobs.data() + jobs.size())
+                return std::nullopt;
+        }
+        else if (arg == "--report" && hasValue)
+            options.report = argv[++i];
+        else
+            return std::nullopt;
+    }
+    return options;
+}
+
+double elapsedMs(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool isFinite(const AdoCpp::Level& level)
+{
+    // The first tile is hit before the level starts, at minus infinity.
+    return std::all_of(level.tiles.begin() + 1, level.tiles.end(),
+                       [](const AdoCpp::Tile& tile)
+                       {
+                           const auto [x, y] = tile.pos.o;
+                           return std::isfinite(tile.seconds) && std::isfinite(tile.beat) && std::isfinite(x) &&
+                               std::isfinite(y);
+                       });
+}
+
+// The timing and the geometry of the tiles after the first one, as parse() leaves them.
+std::vector<double> tileLayout(const AdoCpp::Level& level)
+{
+    std::vector<double> layout;
+    layout.reserve(level.tiles.size() * 4);
+    for (size_t i = 1; i < level.tiles.size(); i++)
+    {
+        const auto& tile = level.tiles[i];
+        layout.insert(layout.end(), {tile.beat, tile.seconds, tile.pos.o.x, tile.pos.o.y});
+    }
+    return layout;
+}
+
+// Dropping a SetSpeed that does not change the bpm may round the times after it differently.
+bool sameLayout(const std::vector<double>& a, const std::vector<double>& b)
+{
+    return std::ranges::equal(a, b, [](const double x, const double y)
+                              { return std::abs(x - y) <= 1e-9 * std::max(1.0, std::abs(x)); });
+}
+
+void writeLevel(const AdoCpp::Level& level, const std::filesystem::path& path, const Format format)
+{
+    if (format == Format::Binary)
+    {
+        level.intoBinary(path, false);
+        return;
+    }
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs.is_open())
+        throw AdoCpp::LevelCouldNotOpenFileException();
+    ofs.write("\xEF\xBB\xBF", 3);
+    rapidjson::OStreamWrapper osw(ofs);
+    rapidjson::PrettyWriter writer(osw);
+    level.write(writer);
+}
+
+void process(Result& result, const Options& options)
+{
+    try
+    {
+        auto start = std::chrono::steady_clock::now();
+        AdoCpp::LoadDiagnostics diagnostics;
+        AdoCpp::Level level;
+        level.fromFile(result.path, diagnostics);
+        result.loadMs = elapsedMs(start);
+        result.warnings = diagnostics.warnings.size();
+        if (!diagnostics.empty())
+            result.status = Status::Warnings, result.message = diagnostics.warnings.front().reason;
+
+        start = std::chrono::steady_clock::now();
+        level.parse();
+        result.parseMs = elapsedMs(start);
+        result.tiles = level.tiles.size();
+        for (const auto& tile : level.tiles)
+            result.events += tile.events.size();
+        if (!isFinite(level))
+        {
+            result.status = Status::Invalid, result.message = "the timing or the geometry is not finite";
+            return;
+        }
+
+        if (options.optimize)
+        {
+            start = std::chrono::steady_clock::now();
+            const auto layout = tileLayout(level);
+            result.removed = level.optimize().total();
+            level.parse();
+            result.optimizeMs = elapsedMs(start);
+            if (!sameLayout(layout, tileLayout(level)))
+            {
+                result.status = Status::Invalid, result.message = "the optimized level has another timing or geometry";
+                return;
+            }
+        }
+
+        if (options.output.empty())
+            return;
+        auto output = options.output / std::filesystem::relative(result.path, options.input);
+        if (options.format == Format::Binary)
+            output.replace_extension(".adobin");
+        std::error_code ec; // Another worker may be creating the same directory.
+        std::filesystem::create_directories(output.parent_path(), ec);
+        start = std::chrono::steady_clock::now();
+        writeLevel(level, output, options.format);
+        result.writeMs = elapsedMs(start);
+
+        if (!options.verify)
+            return;
+        start = std::chrono::steady_clock::now();
+        AdoCpp::LoadDiagnostics writtenDiagnostics;
+        AdoCpp::Level written;
+        if (options.format == Format::Binary)
+            written.fromBinary(output);
+        else
+            written.fromFile(output, writtenDiagnostics);
+        // Compared as json documents, so that a missing decorations array and an empty one are the same.
+        const bool same = *written.intoJson() == *level.intoJson();
+        result.verifyMs = elapsedMs(start);
+        if (!same)
+            result.status = Status::Invalid, result.message = "the written level differs from the original one";
+        else if (writtenDiagnostics.warnings.size() > diagnostics.warnings.size())
+        {
+            result.status = Status::Invalid;
+            result.message = "the written level has more warnings than the original one";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        result.status = Status::Failed;
+        result.message = e.what();
+    }
+}
+
+std::string csvField(const std::string& str)
+{
+    if (str.find_first_of(",\"\n") == std::string::npos)
+        return str;
+    std::string quoted = "\"";
+    for (const char c : str)
+    {
+        if (c == '"')
+            quoted += '"';
+        quoted += c;
+    }
+    return quoted + '"';
+}
+
+void writeReport(std::ostream& os, const std::vector<Result>& results)
+{
+    os << "file,status,bytes,tiles,events,warnings,removed,load_ms,parse_ms,optimize_ms,write_ms,verify_ms,message\n";
+    char timings[128];
+    for (const auto& result : results)
+    {
+        std::snprintf(timings, sizeof(timings), "%.3f,%.3f,%.3f,%.3f,%.3f", result.loadMs, result.parseMs,
+                      result.optimizeMs, result.writeMs, result.verifyMs);
+        os << csvField(result.path.string()) << ',' << cstrStatus[static_cast<int>(result.status)] << ','
+           << result.size << ',' << result.tiles << ',' << result.events << ',' << result.warnings << ','
+           << result.removed << ',' << timings << ',' << csvField(result.message) << '\n';
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    const auto options = parseOptions(argc, argv);
+    if (!options)
+    {
+        std::cerr << usage;
+        return 2;
+    }
+    std::vector<Result> results;
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(
+             options->input, std::filesystem::directory_options::skip_permission_denied, ec),
+         end;
+         !ec && it != end; it.increment(ec))
+    {
+        if (it->is_regular_file(ec) && it->path().extension() == ".adofai")
+            results.push_back({it->path(), it->file_size(ec)});
+    }
+    if (ec)
+    {
+        std::cerr << "Error: " << options->input.string() << ": " << ec.message() << '\n';
+        return 1;
+    }
+    std::ranges::sort(results, {}, &Result::path);
+
+    // The files are claimed one at a time by whichever worker is free, the largest first, so a few huge
+    // levels do not end up queued behind each other at the end of the run.
+    std::vector<size_t> order(results.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::ranges::stable_sort(order, std::greater(), [&results](const size_t i) { return results[i].size; });
+
+    const size_t threads = options->jobs ? options->jobs : std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<size_t> processed = 0;
+    const auto run = [&](const size_t begin, const size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            process(results[order[i]], *options);
+            if (const size_t done = ++processed; done % 100 == 0)
+                std::cerr << done << '/' << results.size() << " files\n";
+        }
+    };
+    const auto start = std::chrono::steady_clock::now();
+    if (threads == 1)
+        run(0, order.size());
+    else
+    {
+        // The calling thread takes part in parallelFor.
+        AdoCpp::ThreadPool pool(threads - 1);
+        pool.parallelFor(0, order.size(), 1, run);
+    }
+    const double totalMs = elapsedMs(start);
+
+    if (options->report.empty())
+        writeReport(std::cout, results);
+    else
+    {
+        std::ofstream ofs(options->report);
+        if (!ofs.is_open())
+        {
+            std::cerr << "Error: could not open " << options->report.string() << '\n';
+            return 1;
+        }
+        writeReport(ofs, results);
+    }
+
+    size_t counts[std::size(cstrStatus)]{};
+    for (const auto& result : results)
+        counts[static_cast<int>(result.status)]++;
+    std::cerr << results.size() << " files in " << totalMs / 1000 << " s on " << threads << " threads: ";
+    for (size_t i = 0; i < std::size(cstrStatus); i++)
+        std::cerr << (i ? ", " : "") << counts[i] << ' ' << cstrStatus[i];
+    std::cerr << '\n';
+    return counts[static_cast<int>(Status::Invalid)] + counts[static_cast<int>(Status::Failed)] == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include <AdoCpp.h>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// Usage: AdoCppEmbed <level.adofai> <name> <output directory>
+// Writes <name>.h and <name>.cpp, which define AdoCpp::Embedded::<name> (see EmbeddedLevel.h).
+
+bool isIdentifier(const std::string& name)
+{
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0])))
+        return false;
+    for (const char c : name)
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_')
+            return false;
+    return true;
+}
+
+// Only write when the contents change, so the dependents are not rebuilt for nothing.
+void writeIfChanged(const std::filesystem::path& path, const std::string& contents)
+{
+    if (std::ifstream ifs(path, std::ios::binary); ifs.is_open())
+    {
+        std::stringstream ss;
+        ss << ifs.rdbuf();
+        if (ss.str() == contents)
+            return;
+    }
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs.is_open())
+        throw AdoCpp::LevelCouldNotOpenFileException();
+    ofs << contents;
+}
+
+int main(const int argc, char* argv[])
+{
+    if (argc != 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <level.adofai> <name> <output directory>\n";
+        return 2;
+    }
+    const std::filesystem::path input = argv[1], outputDirectory = argv[3];
+    const std::string name = argv[2];
+    if (!isIdentifier(name))
+    {
+        std::cerr << "Error: \"" << name << "\" is not a valid C++ identifier.\n";
+        return 2;
+    }
+    try
+    {
+        AdoCpp::LoadDiagnostics diagnostics;
+        AdoCpp::Level level;
+        level.fromFile(input, diagnostics);
+        for (const auto& [action, reason] : diagnostics.warnings)
+            std::cerr << "Warning: " << input.string() << ": " << reason << '\n';
+        if (level.tiles.size() < 2)
+        {
+            std::cerr << "Error: " << input.string() << ": a level must have at least two tiles.\n";
+            return 1;
+        }
+        // Embedded with the parse results, so fromEmbedded() leaves the level parsed.
+        level.parse();
+        const auto data = level.intoBinary();
+
+        std::ostringstream header;
+        header << "// Generated by AdoCppEmbed from " << input.filename().string() << ". Do not edit.\n"
+               << "#pragma once\n\n"
+               << "#include <AdoCpp/EmbeddedLevel.h>\n\n"
+               << "namespace AdoCpp::Embedded\n{\n"
+               << "    extern const EmbeddedLevel " << name << ";\n"
+               << "}\n";
+
+        std::ostringstream source;
+        source << "// Generated by AdoCppEmbed from " << input.filename().string() << ". Do not edit.\n"
+               << "#include \"" << name << ".h\"\n\n"
+               << "namespace\n{\n"
+               << "    alignas(8) constexpr unsigned char data[] = {";
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            if (i % 32 == 0)
+                source << "\n        ";
+            source << static_cast<unsigned>(static_cast<unsigned char>(data[i])) << ',';
+        }
+        source << "\n    };\n"
+               << "}\n\n"
+               << "namespace AdoCpp::Embedded\n{\n"
+               << "    const EmbeddedLevel " << name << "{\"" << name << "\", data, sizeof(data)};\n"
+               << "}\n\n"
+               << "namespace\n{\n"
+               << "    const AdoCpp::EmbeddedLevelRegistrar registrar(AdoCpp::Embedded::" << name << ");\n"
+               << "}\n";
+
+        std::filesystem::create_directories(outputDirectory);
+        writeIfChanged(outputDirectory / (name + ".h"), header.str());
+        writeIfChanged(outputDirectory / (name + ".cpp"), source.str());
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << input.string() << ": " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
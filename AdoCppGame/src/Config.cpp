@@ -30,6 +30,8 @@ void Config::load()
     hidePerfects = document["hidePerfects"].GetBool();
     syncWithMusic = document["syncWithMusic"].GetBool();
     disableAnimationTrack = document["disableAnimationTrack"].GetBool();
+    if (document.HasMember("levelCache"))
+        levelCache = document["levelCache"].GetBool();
     keyLimiter.clear();
     const auto array = document["keyLimiter"].GetArray();
     for (const auto& elem : array)
@@ -51,6 +53,7 @@ void Config::save()
     doc.AddMember("hidePerfects", hidePerfects, doc.GetAllocator());
     doc.AddMember("syncWithMusic", syncWithMusic, doc.GetAllocator());
     doc.AddMember("disableAnimationTrack", disableAnimationTrack, doc.GetAllocator());
+    doc.AddMember("levelCache", levelCache, doc.GetAllocator());
     {
         rapidjson::Value array;
         array.SetArray();
@@ -11,6 +11,7 @@ struct Config
     bool hidePerfects = true;
     bool syncWithMusic = false;
     bool disableAnimationTrack = false;
+    bool levelCache = false;
     using enum sf::Keyboard::Scan;
     std::vector<sf::Keyboard::Scan> keyLimiter = {
         LControl, CapsLock, Tab, Q, W, E, C, Space,
@@ -20,6 +20,8 @@ Game::Game() :
     setlocale(LC_ALL, ".UTF-8");
 
     config.load();
+    if (config.levelCache)
+        level.cacheDirectory("cache/levels");
 
     settings.antiAliasingLevel = 8;
     createWindow();
@@ -66,7 +68,10 @@ Game::Game() :
 
     ImPlot::CreateContext();
 
-    level.defaultLevel();
+    if (const auto* startup = AdoCpp::findEmbeddedLevel("startup"))
+        level.fromEmbedded(*startup);
+    else
+        level.defaultLevel();
     changeState(StateCharting::instance());
 }
 Game::~Game()
@@ -45,6 +45,10 @@ public:
     sf::Font font;
     sf::Text textFps;
 
+    // The music of a pack level streams from the pack, so the pack must outlive the music.
+    AdoCpp::LevelPack pack;
+    std::optional<size_t> packIndex;
+
     sf::Music music;
 
     AdoCpp::Level level;
@@ -19,6 +19,21 @@ constexpr ImGuiWindowFlags ADOCPPGAME_FLAGS =
     ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse;
 
 static std::map<std::string, char*> buffers;
+// A level opened in the editor is loaded into its own Level, which takes the options of the current one
+// (such as the cache directory set in Game::Game()).
+static void copyLevelOptions(const AdoCpp::Level& from, AdoCpp::Level& to)
+{
+    to.disableAnimateTrack(from.disableAnimateTrack());
+    to.parallelUpdate(from.parallelUpdate());
+    to.parallelUpdateThreshold(from.parallelUpdateThreshold());
+    to.parallelDecodeThreshold(from.parallelDecodeThreshold());
+    to.parallelWriteThreshold(from.parallelWriteThreshold());
+    to.writePathData(from.writePathData());
+    to.lazyDecoding(from.lazyDecoding());
+    to.streamingWindow(from.streamingWindow());
+    to.cacheDirectory(from.cacheDirectory());
+    to.cacheSizeLimit(from.cacheSizeLimit());
+}
 static bool ImGuiInputFilename(const char* text, const char* hint, std::string* pathPtr)
 {
     if (ImGui::Button(" " ICON_FA_FOLDER " "))
@@ -99,6 +114,43 @@ static bool ImGuiInputColor(const char* text, AdoCpp::Color* colorPtr)
     return val;
 }
 
+static void levelMetadataPane(const char*, IGFD::UserDatas, bool*)
+{
+    static std::filesystem::path path;
+    static std::optional<AdoCpp::LevelMetadata> metadata;
+    static std::string error;
+    const std::filesystem::path selected = ImGuiFileDialog::Instance()->GetFilePathName();
+    if (selected != path)
+    {
+        // Only peek, so that browsing stays fast even for large levels.
+        path = selected;
+        metadata.reset();
+        error.clear();
+        if (std::filesystem::is_regular_file(path))
+        {
+            try
+            {
+                metadata = AdoCpp::Level::peekMetadata(path);
+            }
+            catch (const std::exception& ex)
+            {
+                error = ex.what();
+            }
+        }
+    }
+    if (metadata)
+    {
+        const AdoCpp::Settings& settings = metadata->settings;
+        ImGui::TextWrapped("Artist: %s", settings.artist.c_str());
+        ImGui::TextWrapped("Song: %s", settings.song.c_str());
+        ImGui::TextWrapped("Author: %s", settings.author.c_str());
+        ImGui::Text("BPM: %g", settings.bpm);
+        ImGui::Text("Tiles: %zu", metadata->tileCount);
+        ImGui::Text("Actions: %zu", metadata->actionCount);
+    }
+    else if (!error.empty())
+        ImGui::TextWrapped("%s", error.c_str());
+}
 
 StateCharting StateCharting::m_stateCharting;
 
@@ -207,7 +259,8 @@ void StateCharting::render()
 {
     // render the world
     game->window.setView(game->view);
-    game->window.draw(game->tileSystem);
+    // While a level is being opened, its first tiles are shown instead of the current level.
+    game->window.draw(previewTileSystem ? *previewTileSystem : game->tileSystem);
 
     // render the GUI
     sf::View defaultView = game->window.getDefaultView();
@@ -246,8 +299,18 @@ void StateCharting::renderFilenameBar()
                 IGFD::FileDialogConfig config;
                 config.path = ".";
                 config.flags = ImGuiFileDialogFlags_Modal;
+                config.sidePane = levelMetadataPane;
+                config.sidePaneWidth = ImGui::GetFontSize() * 15;
                 ImGuiFileDialog::Instance()->OpenDialog("ChooseFileDlgKey", "Choose an ADOFAI file", ".adofai", config);
             }
+            if (ImGui::Button("Open pack ...", ImVec2(-1, 0)))
+            {
+                IGFD::FileDialogConfig config;
+                config.path = ".";
+                config.flags = ImGuiFileDialogFlags_Modal;
+                ImGuiFileDialog::Instance()->OpenDialog("ChoosePackDlgKey", "Choose a level pack", ".adopack", config);
+            }
+            renderPackList();
             if (ImGui::Button("Save as ...", ImVec2(-1, 0)))
             {
                 IGFD::FileDialogConfig config;
@@ -312,18 +375,27 @@ void StateCharting::renderFilenameBar()
         {
             if (ImGuiFileDialog::Instance()->IsOk())
             {
-                game->levelPath = ImGuiFileDialog::Instance()->GetFilePathName();
-                try
-                {
-                    game->level.fromFile(game->levelPath);
-                }
-                catch (const AdoCpp::LevelJsonException&)
-                {
-                    game->levelPath.clear();
-                    game->level.defaultLevel();
-                    ImGui::OpenPopup("Error!##AdoCpp::LevelJsonHasParseErrorException");
-                }
-                newLevel();
+                // Large levels take a while: load in the background and keep the window responsive.
+                loadingPath = ImGuiFileDialog::Instance()->GetFilePathName();
+                loadingLevel = std::make_unique<AdoCpp::Level>();
+                copyLevelOptions(game->level, *loadingLevel);
+                levelLoad = loadingLevel->loadAsync(loadingPath, AdoCpp::ThreadPool::global());
+                ImGui::OpenPopup("Loading level...");
+            }
+            ImGuiFileDialog::Instance()->Close();
+        }
+        renderLoadingPopup();
+        if (ImGuiFileDialog::Instance()->Display("ChoosePackDlgKey"))
+        {
+            if (ImGuiFileDialog::Instance()->IsOk())
+            {
+                // The music may be streaming from the previous pack.
+                game->music = sf::Music();
+                game->packIndex = std::nullopt;
+                if (game->pack.open(ImGuiFileDialog::Instance()->GetFilePathName()) && game->pack.size() != 0)
+                    openPackLevel(0);
+                else
+                    ImGui::OpenPopup("Error!##AdoCpp::LevelPack");
             }
             ImGuiFileDialog::Instance()->Close();
         }
@@ -333,19 +405,31 @@ void StateCharting::renderFilenameBar()
             {
                 const auto path = ImGuiFileDialog::Instance()->GetFilePathName();
                 std::ofstream ofs(path, std::ios::binary);
-                std::unique_ptr<rapidjson::Document> doc = game->level.intoJson();
                 rapidjson::OStreamWrapper osw(ofs);
                 rapidjson::EncodedOutputStream<rapidjson::UTF8<>, rapidjson::OStreamWrapper> eos(osw, true);
                 rapidjson::PrettyWriter writer(eos);
-                doc->Accept(writer);
+                game->level.write(writer);
             }
             ImGuiFileDialog::Instance()->Close();
         }
+        // Opened here, since the errors are found inside other popups and combos.
+        if (!loadError.empty() && !ImGui::IsPopupOpen("Error!##LoadLevel"))
+            ImGui::OpenPopup("Error!##LoadLevel");
+        ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+        if (ImGui::BeginPopupModal("Error!##LoadLevel", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+        {
+            ImGui::Text("Failed to open the level. %s", loadError.c_str());
+            if (ImGui::Button("Close"))
+            {
+                loadError.clear();
+                ImGui::CloseCurrentPopup();
+            }
+            ImGui::EndPopup();
+        }
         ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
-        if (ImGui::BeginPopupModal("Error!##AdoCpp::LevelJsonHasParseErrorException", nullptr,
-                                   ImGuiWindowFlags_AlwaysAutoResize))
+        if (ImGui::BeginPopupModal("Error!##AdoCpp::LevelPack", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
         {
-            ImGui::Text("Error when parsing json.");
+            ImGui::Text("The file is not a level pack or it is empty.");
             if (ImGui::Button("Close"))
                 ImGui::CloseCurrentPopup();
             ImGui::EndPopup();
@@ -353,6 +437,93 @@ void StateCharting::renderFilenameBar()
     }
     ImGui::End();
 }
+void StateCharting::renderLoadingPopup()
+{
+    ImGui::SetNextWindowPos(ImGui::GetMainViewport()->GetCenter(), ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+    if (!ImGui::BeginPopupModal("Loading level...", nullptr, ImGuiWindowFlags_AlwaysAutoResize))
+        return;
+    if (!previewTileSystem)
+    {
+        // Show the first tiles as soon as they have been read.
+        if (const auto angles = levelLoad.preview(); !angles.empty())
+        {
+            previewLevel.clear();
+            previewLevel.tiles.emplace_back(0);
+            for (const double angle : angles)
+                previewLevel.tiles.emplace_back(angle);
+            previewLevel.parse();
+            previewLevel.update();
+            previewTileSystem = std::make_unique<TileSystem>(previewLevel);
+            previewTileSystem->update();
+            game->view.setCenter({0.f, 0.f});
+        }
+    }
+    ImGui::Text("%s...", AdoCpp::loadStage2cstr(levelLoad.stage()));
+    ImGui::ProgressBar(levelLoad.progress(), ImVec2(ImGui::GetFontSize() * 15, 0));
+    if (ImGui::Button("Cancel", ImVec2(-1, 0)))
+        levelLoad.cancel();
+    if (levelLoad.ready())
+    {
+        try
+        {
+            levelLoad.get();
+            game->level = std::move(*loadingLevel);
+            game->levelPath = loadingPath;
+            game->packIndex = std::nullopt;
+            newLevel();
+        }
+        catch (const AdoCpp::LevelLoadCancelledException&)
+        {
+        }
+        catch (const std::exception& ex)
+        {
+            loadError = ex.what();
+        }
+        levelLoad = {};
+        loadingLevel.reset();
+        previewTileSystem.reset();
+        previewLevel.clear();
+        ImGui::CloseCurrentPopup();
+    }
+    ImGui::EndPopup();
+}
+void StateCharting::renderPackList()
+{
+    if (!game->pack.isOpen())
+        return;
+    const std::string preview(game->packIndex ? game->pack[*game->packIndex].name : "");
+    if (!ImGui::BeginCombo("##PackList", preview.c_str(), ImGuiComboFlags_HeightLarge))
+        return;
+    for (size_t i = 0; i < game->pack.size(); i++)
+    {
+        const auto name = game->pack[i].name;
+        ImGui::PushID(static_cast<int>(i));
+        if (ImGui::Selectable(std::string(name).c_str(), game->packIndex == i))
+            openPackLevel(i);
+        ImGui::PopID();
+    }
+    ImGui::EndCombo();
+}
+void StateCharting::openPackLevel(const size_t index)
+{
+    // The level is already compiled and the music is already in memory: nothing is read from the disk.
+    // It is loaded into its own Level, so a corrupt entry leaves the current one intact.
+    AdoCpp::Level level;
+    copyLevelOptions(game->level, level);
+    try
+    {
+        game->pack.load(index, level);
+    }
+    catch (const std::exception& ex)
+    {
+        loadError = ex.what();
+        return;
+    }
+    game->level = std::move(level);
+    game->packIndex = index;
+    game->levelPath = std::string(game->pack[index].name);
+    newLevel();
+}
 void StateCharting::renderLevelSettings() const
 {
     const float width = ImGui::GetFontSize() * 15, height = ImGui::GetFontSize() * 30;
@@ -742,10 +913,19 @@ void StateCharting::newLevel()
     game->level.update();
     game->tileSystem.parse();
     game->tileSystem.update();
-    game->origMusicPath = game->musicPath = game->levelPath.parent_path().append(game->level.settings.songFilename);
-    if (!game->musicPath.empty())
+    if (game->packIndex)
+    {
+        game->origMusicPath = game->musicPath = {};
+        const auto& entry = game->pack[*game->packIndex];
+        if (entry.audio.empty())
+            game->music = sf::Music(); // Do not keep playing the music of the previous level.
+        else if (!game->music.openFromMemory(entry.audio.data(), entry.audio.size()))
+            std::cerr << "Warning: Failed to load the music of \"" << entry.name << "\" from the level pack.";
+    }
+    else
     {
-        if (!game->music.openFromFile(game->musicPath))
+        game->origMusicPath = game->musicPath = game->levelPath.parent_path().append(game->level.settings.songFilename);
+        if (!game->musicPath.empty() && !game->music.openFromFile(game->musicPath))
         {
             std::cerr << "Warning: Failed to load music from file \"" << game->musicPath
                       << "\". Maybe the file does not exist or it is not a music file.";
@@ -26,6 +26,9 @@ public:
     void renderSMiscellaneous() const;
     void renderSDecorations() const;
     void parseUpdateLevel(size_t floor) const;
+    void renderLoadingPopup();
+    void renderPackList();
+    void openPackLevel(size_t index);
 
 	void newLevel();
 
@@ -41,4 +44,11 @@ private:
 	static StateCharting m_stateCharting;
 	bool addedHitsound{};
     bool dragging{};
+    // The level being opened is loaded into its own Level, so the current one stays usable until it is replaced.
+    std::unique_ptr<AdoCpp::Level> loadingLevel;
+    std::filesystem::path loadingPath;
+    AdoCpp::LevelLoad levelLoad;
+    AdoCpp::Level previewLevel;
+    std::unique_ptr<TileSystem> previewTileSystem;
+    std::string loadError;
 };
\ No newline at end of file
@@ -18,14 +18,17 @@ std::filesystem::path getPath()
 int main()
 {
     const std::filesystem::path path = getPath();
-    AdoCpp::Level level{path};
-    level.parse();
+    // Only the timing is needed, so the other actions are never decoded.
+    AdoCpp::Level level;
+    level.lazyDecoding(true);
+    level.fromFile(path);
+    level.parse(0, true);
     const auto start = std::chrono::high_resolution_clock::now();
-    for (size_t i = 1; i < level.getTiles().size(); i++)
+    for (size_t i = 1; i < level.tiles.size(); i++)
     {
-        auto duration = std::chrono::milliseconds(static_cast<long long>(level.getTiles()[i].seconds * 1000));
+        auto duration = std::chrono::milliseconds(static_cast<long long>(level.tiles[i].seconds * 1000));
         std::this_thread::sleep_until(start + duration);
-        printf("floor: %llu sec: %.3f\n", i, level.getTiles()[i].seconds);
+        printf("floor: %llu sec: %.3f\n", i, level.tiles[i].seconds);
     }
     return 0;
 }
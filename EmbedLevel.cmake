@@ -0,0 +1,18 @@
+# adocpp_embed_level(<target> <name> <level.adofai>)
+#
+# Compiles the level at build time and links it into the target as AdoCpp::Embedded::<name>
+# (declared in the generated header <name>.h), so that Level::fromEmbedded loads it without reading
+# or parsing any json. The level is recompiled whenever the file or AdoCppEmbed changes.
+function(adocpp_embed_level target name file)
+    get_filename_component(file ${file} ABSOLUTE)
+    set(dir ${CMAKE_CURRENT_BINARY_DIR}/embedded)
+    add_custom_command(
+            OUTPUT ${dir}/${name}.h ${dir}/${name}.cpp
+            COMMAND AdoCppEmbed ${file} ${name} ${dir}
+            DEPENDS AdoCppEmbed ${file}
+            COMMENT "Embedding level ${file} as ${name}"
+            VERBATIM
+    )
+    target_sources(${target} PRIVATE ${dir}/${name}.h ${dir}/${name}.cpp)
+    target_include_directories(${target} PRIVATE ${dir} ${PROJECT_SOURCE_DIR}/AdoCpp/src)
+endfunction()
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <AdoCpp.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// What the test programs share. A test program reports each failed check and exits with Test::result().
+
+namespace Test
+{
+    inline int failures = 0;
+
+    inline void check(const bool ok, const char* what)
+    {
+        if (!ok)
+        {
+            std::cerr << "FAILED: " << what << '\n';
+            failures++;
+        }
+    }
+    inline int result() { return failures == 0 ? 0 : 1; }
+
+    // Load a level from json text, leaving the warnings in diagnostics.
+    inline void loadLevel(AdoCpp::Level& level, const char* json, AdoCpp::LoadDiagnostics& diagnostics)
+    {
+        rapidjson::Document document;
+        document.Parse(json);
+        level.fromJson(document, diagnostics);
+    }
+
+    inline size_t eventCount(const AdoCpp::Level& level)
+    {
+        size_t events = 0;
+        for (const auto& tile : level.tiles)
+            events += tile.events.size();
+        return events;
+    }
+
+    // The timing and the geometry of the tiles after the first one, as parse() leaves them.
+    inline std::vector<double> tileLayout(const AdoCpp::Level& level)
+    {
+        std::vector<double> layout;
+        for (size_t i = 1; i < level.tiles.size(); i++)
+        {
+            const auto& tile = level.tiles[i];
+            layout.insert(layout.end(), {tile.beat, tile.seconds, tile.pos.o.x, tile.pos.o.y});
+        }
+        return layout;
+    }
+    inline bool sameLayout(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        return std::ranges::equal(a, b, [](const double x, const double y)
+                                  { return std::abs(x - y) <= 1e-9 * std::max(1.0, std::abs(x)); });
+    }
+} // namespace Test
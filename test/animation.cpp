@@ -0,0 +1,30 @@
+#include "TestSupport.h"
+
+// A track animation lasts half a beat at the tempo in effect when its tile starts: a SetSpeed partway through the
+// tile only applies from the next one.
+
+constexpr auto LEVEL = R"({
+    "pathData": "RRRRR",
+    "settings": {"bpm": 100, "trackAnimation": "Fade", "beatsAhead": 2},
+    "actions": [
+        {"floor": 2, "eventType": "SetSpeed", "speedType": "Bpm", "beatsPerMinute": 200, "bpmMultiplier": 1,
+         "angleOffset": 90},
+        {"floor": 4, "eventType": "SetSpeed", "speedType": "Bpm", "beatsPerMinute": 300, "bpmMultiplier": 1}
+    ]
+})";
+
+bool near(const double a, const double b) { return std::abs(a - b) < 1e-9; }
+
+int main()
+{
+    AdoCpp::LoadDiagnostics diagnostics;
+    AdoCpp::Level level;
+    Test::loadLevel(level, LEVEL, diagnostics);
+    level.parse();
+
+    Test::check(near(level.tiles[1].animationDuration, 0.3), "half a beat at the initial bpm");
+    Test::check(near(level.tiles[2].animationDuration, 0.3), "a SetSpeed with an angle offset starts after its tile");
+    Test::check(near(level.tiles[3].animationDuration, 0.15), "the next tile has the new bpm");
+    Test::check(near(level.tiles[4].animationDuration, 0.1), "a SetSpeed without an angle offset starts with its tile");
+    return Test::result();
+}
@@ -0,0 +1,139 @@
+#include <cstddef>
+#include <cstring>
+#include <functional>
+
+#include "TestSupport.h"
+
+// Level::intoBinary() and Level::fromBinary() must round-trip the tiles, settings and events, restore the parse
+// results so that the level plays the same without parse(), and reject a corrupt binary with LevelBinaryException
+// only, whether it is truncated or has a field out of range.
+
+constexpr auto LEVEL = R"({
+    "pathData": "RRUL5RRQRR",
+    "settings": {"bpm": 150, "offset": 250, "pitch": 110, "artist": "someone", "trackAnimation": "Fade",
+                 "beatsAhead": 2},
+    "actions": [
+        {"floor": 1, "eventType": "Twirl"},
+        {"floor": 2, "eventType": "SetSpeed", "speedType": "Multiplier", "beatsPerMinute": 100, "bpmMultiplier": 1.5,
+         "angleOffset": 90},
+        {"floor": 3, "eventType": "ColorTrack", "trackColorType": "Single", "trackColor": "ff0000",
+         "secondaryTrackColor": "ffffff", "trackColorAnimDuration": 2, "trackStyle": "Standard"},
+        {"floor": 4, "eventType": "MoveTrack", "startTile": [0, "ThisTile"], "endTile": [2, "ThisTile"],
+         "duration": 1, "positionOffset": [1, null], "ease": "OutSine", "active": false},
+        {"floor": 4, "eventType": "MoveTrack", "startTile": [-1, "ThisTile"], "endTile": [3, "ThisTile"],
+         "duration": 2, "positionOffset": [null, 2], "rotationOffset": 45, "ease": "InOutQuad", "angleOffset": 45},
+        {"floor": 5, "eventType": "SetHitsound", "gameSound": "Midspin", "hitsound": "Hat", "hitsoundVolume": 80},
+        {"floor": 6, "eventType": "Pause", "duration": 1, "countdownTicks": 0, "angleCorrectionDir": -1},
+        {"floor": 7, "eventType": "AnimateTrack", "trackAnimation": "Scatter", "beatsAhead": 3,
+         "trackDisappearAnimation": "Retract", "beatsBehind": 1}
+    ]
+})";
+
+// What update() leaves in the tiles at some moments of the level.
+std::vector<double> frames(AdoCpp::Level& level)
+{
+    std::vector<double> values;
+    for (const double seconds : {-1.0, 0.5, 1.5, 2.5, 4.0, 6.0})
+    {
+        level.update(seconds);
+        for (const auto& tile : level.tiles)
+            values.insert(values.end(), {tile.pos.c.x, tile.pos.c.y, tile.rotation.c, tile.scale.c.x, tile.opacity,
+                                         static_cast<double>(tile.color.toInteger())});
+    }
+    return values;
+}
+
+template <typename T>
+void patch(std::vector<char>& data, const AdoCpp::Binary::Section section, const size_t offset, const T value)
+{
+    const auto header = AdoCpp::Binary::readHeader(data.data(), data.size());
+    std::memcpy(data.data() + header->sections[static_cast<size_t>(section)].offset + offset, &value, sizeof(value));
+}
+
+// Whether loading the data throws LevelBinaryException (and nothing else).
+bool rejected(const std::vector<char>& data, const size_t size)
+{
+    try
+    {
+        AdoCpp::Level level;
+        level.fromBinary(data.data(), size);
+    }
+    catch (const AdoCpp::LevelBinaryException&)
+    {
+        return true;
+    }
+    catch (...)
+    {
+    }
+    return false;
+}
+
+int main()
+{
+    using namespace AdoCpp::Binary;
+
+    AdoCpp::LoadDiagnostics diagnostics;
+    AdoCpp::Level level;
+    Test::loadLevel(level, LEVEL, diagnostics);
+    Test::check(Test::eventCount(level) == 8, "every action is loaded");
+
+    const auto plain = level.intoBinary(false);
+    AdoCpp::Level loaded;
+    loaded.fromBinary(plain.data(), plain.size());
+    Test::check(AdoCpp::compactJson(*loaded.intoJson()) == AdoCpp::compactJson(*level.intoJson()),
+                "the level is unchanged by a round trip");
+    Test::check(!loaded.isParsed(), "a binary without parse results is left unparsed");
+
+    level.parse();
+    const auto data = level.intoBinary();
+    AdoCpp::Level restored;
+    restored.fromBinary(data.data(), data.size());
+    Test::check(restored.isParsed(), "the parse results are restored");
+    Test::check(Test::sameLayout(Test::tileLayout(restored), Test::tileLayout(level)),
+                "the tile timing and geometry are restored");
+    bool sameMoveTracks = true;
+    for (size_t i = 0; i < level.tiles.size(); i++)
+        sameMoveTracks &= restored.tiles[i].moveTrackDatas.size() == level.tiles[i].moveTrackDatas.size();
+    Test::check(sameMoveTracks && restored.tiles[5].moveTrackDatas.size() == 1, "the MoveTracks are restored");
+    Test::check(Test::sameLayout(frames(restored), frames(level)), "the restored level plays the same");
+
+    size_t truncated = 0;
+    for (size_t size = 0; size < data.size(); size++)
+        truncated += rejected(data, size);
+    Test::check(truncated == data.size(), "every truncated binary is rejected");
+
+    const std::pair<const char*, std::function<void(std::vector<char>&)>> corruptions[] = {
+        {"an event count larger than the events",
+         [](auto& d) { patch<uint64_t>(d, Section::Events, 0, 1000); }},
+        {"an event on a tile out of range",
+         [](auto& d) { patch<uint64_t>(d, Section::Events, sizeof(uint64_t) + 8, 1000); }},
+        {"a string out of range",
+         [](auto& d) { patch<uint32_t>(d, Section::Settings, sizeof(int), 1u << 30); }},
+        {"a tile enumerator out of range",
+         [](auto& d) { patch<uint8_t>(d, Section::TileResults, offsetof(TileRecord, trackStyle), 200); }},
+        {"a tile orbit out of range",
+         [](auto& d) { patch<uint8_t>(d, Section::TileResults, offsetof(TileRecord, orbit), 2); }},
+        {"an animation floor out of range",
+         [](auto& d) { patch<uint64_t>(d, Section::TileResults, offsetof(TileRecord, trackAnimationFloor), 1000); }},
+        {"a tempo segment on a tile out of range",
+         [](auto& d) { patch<uint64_t>(d, Section::TempoMap, offsetof(TempoRecord, floor), 1000); }},
+        {"a MoveTrack on a tile out of range",
+         [](auto& d) { patch<uint64_t>(d, Section::MoveTracks, offsetof(MoveTrackRecord, tile), 1000); }},
+        {"a MoveTrack ease out of range",
+         [](auto& d) { patch<uint32_t>(d, Section::MoveTracks, offsetof(MoveTrackRecord, ease), 1000); }},
+        {"parse results without a tempo map",
+         [](auto& d)
+         {
+             auto header = *readHeader(d.data(), d.size());
+             header.sections[static_cast<size_t>(Section::TempoMap)].size = 0;
+             std::memcpy(d.data(), &header, sizeof(header));
+         }},
+    };
+    for (const auto& [what, corrupt] : corruptions)
+    {
+        auto corrupted = data;
+        corrupt(corrupted);
+        Test::check(rejected(corrupted, corrupted.size()), what);
+    }
+    return Test::result();
+}
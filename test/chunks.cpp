@@ -0,0 +1,88 @@
+#include <limits>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/writer.h>
+#include <string>
+
+#include "TestSupport.h"
+
+// Writing the actions in parallel chunks (see Level::parallelWriteThreshold()) must give the same bytes as writing
+// them serially, with a Writer and with a PrettyWriter, whatever the settings of the writer.
+
+// A level with more actions than the default threshold, spread unevenly over the tiles.
+std::string bigLevel()
+{
+    constexpr size_t tiles = 6000;
+    std::string json = R"({"pathData": ")" + std::string(tiles, 'R') + R"(", "settings": {"bpm": 120}, "actions": [)";
+    for (size_t floor = 1, actions = 0; floor < tiles; floor++)
+        for (size_t i = 0; i < floor % 7; i++, actions++)
+        {
+            if (actions > 0)
+                json += ',';
+            const std::string f = std::to_string(floor);
+            if (i % 3 == 0)
+                json += R"({"floor": )" + f + R"(, "eventType": "Twirl"})";
+            else if (i % 3 == 1)
+                json += R"({"floor": )" + f + R"(, "eventType": "SetSpeed", "speedType": "Multiplier",
+                          "beatsPerMinute": 100, "bpmMultiplier": 1.0000123, "angleOffset": 45.5})";
+            else
+                json += R"({"floor": )" + f + R"(, "eventType": "MoveTrack", "startTile": [0, "ThisTile"],
+                          "endTile": [2, "ThisTile"], "duration": 0.333333, "positionOffset": [1.25, null],
+                          "ease": "OutSine", "eventTag": "tag \"é\" \\ )" + f + R"("})";
+        }
+    return json + "]}";
+}
+
+template <typename Writer>
+std::string write(AdoCpp::Level& level, const size_t threshold, void (*setup)(Writer&))
+{
+    level.parallelWriteThreshold(threshold);
+    rapidjson::StringBuffer buffer;
+    Writer writer(buffer);
+    setup(writer);
+    level.write(writer);
+    return buffer.GetString();
+}
+
+template <typename Writer>
+void compare(AdoCpp::Level& level, const char* what, void (*setup)(Writer&))
+{
+    const std::string serial = write<Writer>(level, std::numeric_limits<size_t>::max(), setup);
+    rapidjson::Document document;
+    document.Parse(serial.c_str());
+    Test::check(!document.HasParseError() && document["actions"].Size() == Test::eventCount(level),
+                (std::string(what) + ": the serial output is the level").c_str());
+    Test::check(write<Writer>(level, 0, setup) == serial,
+                (std::string(what) + ": parallelWriteThreshold(0) gives the serial output").c_str());
+    const size_t threshold = AdoCpp::Level().parallelWriteThreshold();
+    Test::check(write<Writer>(level, threshold, setup) == serial,
+                (std::string(what) + ": the default threshold gives the serial output").c_str());
+}
+
+int main()
+{
+    using Writer = rapidjson::Writer<rapidjson::StringBuffer>;
+    using PrettyWriter = rapidjson::PrettyWriter<rapidjson::StringBuffer>;
+
+    AdoCpp::LoadDiagnostics diagnostics;
+    AdoCpp::Level level;
+    const std::string json = bigLevel();
+    Test::loadLevel(level, json.c_str(), diagnostics);
+    Test::check(Test::eventCount(level) > AdoCpp::Level().parallelWriteThreshold(),
+                "the level has more actions than the default threshold");
+
+    compare<Writer>(level, "Writer", [](Writer&) {});
+    compare<Writer>(level, "Writer with 2 decimal places", [](Writer& w) { w.SetMaxDecimalPlaces(2); });
+    compare<PrettyWriter>(level, "PrettyWriter", [](PrettyWriter&) {});
+    compare<PrettyWriter>(level, "PrettyWriter with tabs and single line arrays",
+                          [](PrettyWriter& w)
+                          {
+                              w.SetIndent('\t', 1);
+                              w.SetFormatOptions(rapidjson::kFormatSingleLineArray);
+                          });
+
+    AdoCpp::Level empty;
+    Test::loadLevel(empty, R"({"pathData": "RRRR", "settings": {"bpm": 120}, "actions": []})", diagnostics);
+    compare<Writer>(empty, "Writer without actions", [](Writer&) {});
+    compare<PrettyWriter>(empty, "PrettyWriter without actions", [](PrettyWriter&) {});
+    return Test::result();
+}
@@ -0,0 +1,49 @@
+#include <filesystem>
+#include <fstream>
+#include <rapidjson/writer.h>
+
+#include "TestSupport.h"
+
+// With lazyDecoding(true), the deferred actions must not point into the file, which is unmapped once fromFile()
+// returns: parsing and writing the level afterwards must give what an eager load gives.
+
+constexpr auto LEVEL = R"({
+    "pathData": "RRRRRRRRRR",
+    "settings": {"bpm": 120},
+    "actions": [
+        {"floor": 1, "eventType": "MoveTrack", "startTile": [0, "ThisTile"], "endTile": [2, "ThisTile"],
+         "duration": 1, "positionOffset": [1, 0], "ease": "OutSine"},
+        {"floor": 2, "eventType": "SetSpeed", "speedType": "Bpm", "beatsPerMinute": 200, "bpmMultiplier": 1},
+        {"floor": 3, "eventType": "MoveCamera", "duration": 2, "relativeTo": "Tile", "position": [1, 2],
+         "ease": "InOutQuad"},
+        {"floor": 4, "eventType": "RecolorTrack", "startTile": [-1, "ThisTile"], "endTile": [1, "ThisTile"],
+         "trackColorType": "Single", "trackColor": "00ff00", "secondaryTrackColor": "ffffff",
+         "trackColorAnimDuration": 2, "trackColorPulse": "None", "trackPulseLength": 10, "trackStyle": "Neon"}
+    ]
+})";
+
+std::string loadAndWrite(const std::filesystem::path& path, const bool lazy)
+{
+    AdoCpp::LoadDiagnostics diagnostics;
+    AdoCpp::Level level;
+    level.lazyDecoding(lazy);
+    level.fromFile(path, diagnostics);
+    level.parse();
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer writer(buffer);
+    level.write(writer);
+    return buffer.GetString();
+}
+
+int main()
+{
+    const auto path = std::filesystem::temp_directory_path() / "AdoCpp_test_lazy.adofai";
+    std::ofstream(path, std::ios::binary) << LEVEL;
+
+    const std::string eager = loadAndWrite(path, false), lazy = loadAndWrite(path, true);
+    std::filesystem::remove(path);
+    Test::check(eager.find("OutSine") != std::string::npos && eager.find("InOutQuad") != std::string::npos,
+                "the deferred types are written");
+    Test::check(lazy == eager, "a lazily loaded level is written like an eagerly loaded one");
+    return Test::result();
+}
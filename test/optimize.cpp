@@ -0,0 +1,55 @@
+#include "TestSupport.h"
+
+// Level::optimize() must only remove events that have no effect: the timing and the geometry of the tiles stay
+// the same.
+
+constexpr auto LEVEL = R"({
+    "pathData": "RRRRRRRRRRRRRRRRRRRR",
+    "settings": {"bpm": 120},
+    "actions": [
+        {"floor": 1, "eventType": "Twirl", "active": false},
+        {"floor": 2, "eventType": "SetSpeed", "speedType": "Bpm", "beatsPerMinute": 200, "bpmMultiplier": 1},
+        {"floor": 2, "eventType": "SetSpeed", "speedType": "Multiplier", "beatsPerMinute": 100, "bpmMultiplier": 2},
+        {"floor": 3, "eventType": "SetSpeed", "speedType": "Multiplier", "beatsPerMinute": 100, "bpmMultiplier": 1},
+        {"floor": 4, "eventType": "Twirl"},
+        {"floor": 5, "eventType": "ColorTrack", "trackColorType": "Single", "trackColor": "ff0000",
+         "secondaryTrackColor": "ffffff", "trackColorAnimDuration": 2, "trackStyle": "Standard"},
+        {"floor": 6, "eventType": "ColorTrack", "trackColorType": "Single", "trackColor": "ff0000",
+         "secondaryTrackColor": "ffffff", "trackColorAnimDuration": 2, "trackStyle": "Standard"},
+        {"floor": 7, "eventType": "MoveTrack", "startTile": [0, "ThisTile"], "endTile": [2, "ThisTile"],
+         "duration": 1, "ease": "Linear"},
+        {"floor": 8, "eventType": "MoveTrack", "startTile": [0, "ThisTile"], "endTile": [2, "ThisTile"],
+         "duration": 1, "positionOffset": [1, 0], "ease": "Linear", "active": false},
+        {"floor": 9, "eventType": "SetHitsound", "gameSound": "Hitsound", "hitsound": "Kick", "hitsoundVolume": 100},
+        {"floor": 9, "eventType": "SetHitsound", "gameSound": "Midspin", "hitsound": "Hat", "hitsoundVolume": 100},
+        {"floor": 10, "eventType": "Pause", "duration": 1, "countdownTicks": 0, "angleCorrectionDir": -1},
+        {"floor": 10, "eventType": "Pause", "duration": 2, "countdownTicks": 0, "angleCorrectionDir": -1}
+    ]
+})";
+
+int main()
+{
+    AdoCpp::LoadDiagnostics diagnostics;
+    AdoCpp::Level level;
+    Test::loadLevel(level, LEVEL, diagnostics);
+    level.parse();
+    const auto layout = Test::tileLayout(level);
+    const size_t events = Test::eventCount(level);
+
+    const auto stats = level.optimize();
+    level.parse();
+
+    Test::check(events == 13, "every action is loaded");
+    Test::check(stats.inactive == 2, "the inactive Twirl and MoveTrack are removed");
+    Test::check(stats.overridden == 1, "only the first Pause of floor 10 is overridden");
+    Test::check(stats.colorTracks == 1, "the repeated ColorTrack is removed");
+    Test::check(stats.moveTracks == 1, "the MoveTrack that sets nothing is removed");
+    Test::check(stats.setSpeeds == 2, "the SetSpeed chain is merged and the one keeping the bpm is dropped");
+    Test::check(Test::eventCount(level) == events - stats.total(), "the stats count every removed event");
+    Test::check(level.tiles[9].events.size() == 2, "both hitsounds of floor 9 are kept");
+    Test::check(level.tiles[10].events.size() == 1 &&
+                    static_cast<const AdoCpp::Event::GamePlay::Pause&>(*level.tiles[10].events[0]).duration == 2,
+                "the last Pause of floor 10 is kept");
+    Test::check(Test::sameLayout(layout, Test::tileLayout(level)), "the timing and the geometry are unchanged");
+    return Test::result();
+}